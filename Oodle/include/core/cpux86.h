@@ -20,6 +20,7 @@
 #define RRX86_CPU_AVX2		(1U<<8)
 #define RRX86_CPU_AMD_ZEN	(1U<<9)		// not a CPUID bit; checks for AMD Zen uArch chips
 #define RRX86_CPU_F16C          (1U<<10)        // float16 conversion instructions
+#define RRX86_CPU_AVX512	(1U<<11)		// AVX-512 F+BW+VL+VBMI+VBMI2 with OS ZMM state support (Ice Lake, Zen 4 and later)
 
 // HOW TO USE:
 // - call rrCPUx86_detect() to init (calling multiple times is perfectly safe)
@@ -163,6 +163,8 @@ struct CTMF
 		{
 			ptr = OodleMalloc(alloc_size);
 			m_hash_table_alloc = ptr;
+			// CTMF is filled and probed by one thread ; reset() below is the first touch
+			OodleMemoryHint(ptr,alloc_size,OODLE_MEMORY_HINT_LARGE_RANDOM_ACCESS|OODLE_MEMORY_HINT_THREAD_LOCAL);
 		}
 		
 		// align to cache line so hash ways are in one line :
@@ -364,6 +366,29 @@ struct CTMF
 		}
 	}
 	
+	// prefetch the rows for ptr without touching m_next
+	//	for looking further ahead than prefetch_next
+	void prefetch_rows(const U8 * ptr)
+	{
+		U32 h = hash(ptr);
+		t_hashtype * row = m_hash_table + (h & m_hash_row_mask);
+
+		if ( c_table_depth*sizeof(t_hashtype) > 32 )
+			RR_PREFETCHRW_64B(row);
+		else
+			RR_PREFETCHRW_32B(row);
+
+		if ( c_do_second_hash )
+		{
+			t_hashtype * row_second = m_hash_table + second_hash_index(h,ptr);
+
+			if ( c_table_depth*sizeof(t_hashtype) > 32 )
+				RR_PREFETCHRW_64B(row_second);
+			else
+				RR_PREFETCHRW_32B(row_second);
+		}
+	}
+
 	void set_next(const U8 * ptr)
 	{
 		m_next_ptr = ptr;
@@ -979,12 +1004,17 @@ struct CTMF2
 //=======================================================================
 
 // "Fast" CTMF is for HyperFast encoders
-// - no prefetch (assumed to be all in L2 or L1)
+// - no prefetch of the table (assumed to be all in L2 or L1) ; see fast_ctmf_pipeline_next for the match bytes
 // - no collision bits
 // - always depth 1
 
 // the idea is to use the inline functions with all the pointers etc. cached in local vars
 
+// NOTE : hashing/probing 8 positions at a time with AVX2 was tried here and lost (0.5-0.95x) :
+//	the HyperFast literal loops take step 1 only for their first 8-16 probes, and on most data
+//	the literal run ends in the first few of those, so a batch mostly gets thrown away.
+//	the hash multiply is not the bottleneck ; the match-byte load is (hence the pipelining).
+
 namespace
 {
 
@@ -1014,6 +1044,29 @@ static RADFORCEINLINE t_hashtype fast_ctmf_insert(t_hashtype * hash_table, const
 	return hashpos;
 }
 
+// insert with a hash computed ahead of time (see fast_ctmf_pipeline_next)
+template <typename t_hashtype>
+static RADFORCEINLINE t_hashtype fast_ctmf_insert_hashed(t_hashtype * hash_table, UINTa hash, SINTa pos)
+{
+	t_hashtype hashpos = hash_table[hash];
+	hash_table[hash] = static_cast<t_hashtype>(pos);
+	return hashpos;
+}
+
+// software pipelining for the literal-skip loops :
+//	hash the next probe position one step early and start fetching the bytes its
+//	table entry currently points at, so that load isn't on the critical path next time.
+// the entry may get overwritten before the next probe ; that only wastes the prefetch,
+//	it never changes the parse.
+template <typename t_hashtype>
+static RADFORCEINLINE UINTa fast_ctmf_pipeline_next(const t_hashtype * hash_table, const U8 * next_ptr, SINTa next_pos, U64 hash_mul, int hash_shift)
+{
+	UINTa hash = fast_ctmf_hash(RR_GET64_LE_UNALIGNED(next_ptr),hash_mul,hash_shift);
+	t_hashtype hashpos = hash_table[hash];
+	RR_PREFETCHR_CL(next_ptr - (t_hashtype)(next_pos - hashpos));
+	return hash;
+}
+
 };
 
 template <typename t_hashtype>
@@ -1080,6 +1133,8 @@ struct FastCTMF
 		{
 			ptr = OodleMalloc(alloc_size);
 			m_hash_table_alloc = ptr;
+			// CTMF is filled and probed by one thread ; reset() below is the first touch
+			OodleMemoryHint(ptr,alloc_size,OODLE_MEMORY_HINT_LARGE_RANDOM_ACCESS|OODLE_MEMORY_HINT_THREAD_LOCAL);
 		}
 
 		// align to cache line so hash ways are in one line :
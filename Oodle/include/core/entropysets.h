@@ -90,6 +90,9 @@ U32 entropysets_order0_codelen_bits(const Histo256 & histo,SINTa sumCounts);
 // SSE4 version. Only present on x86 targets.
 U32 entropysets_order0_codelen_bits_sse4(const Histo256 & histo,SINTa sumCounts);
 
+// AVX2 version. Only present on x86 targets.
+U32 entropysets_order0_codelen_bits_avx2(const Histo256 & histo,SINTa sumCounts);
+
 //===============================================================================
 
 struct entropyset
@@ -111,6 +111,10 @@ LRMCascade * LRM_CreateCascade(const U8 * buffer, SINTa bufSize, int step, int j
 						SINTa base_chunkSize, int hash_length);
 LRMCascade * LRM_CreateCascadeIncremental(const U8 * buffer, SINTa bufSize, int step, int jumpBits_0, int jumpBits_inc,
 						SINTa base_chunkSize, int hash_length);
+// All at once, the chunk fills and merges run as a DAG of jobs
+//	waits on the jobs, so call it from the thread that started the compress
+LRMCascade * LRM_CreateCascadeJobified(const U8 * buffer, SINTa bufSize, int step, int jumpBits_0, int jumpBits_inc,
+						SINTa base_chunkSize, int hash_length, void * jobifyUserPtr);
 void LRM_DestroyCascade(LRMCascade * casc);
 
 LRMCascade * LRM_AllocCascade();
@@ -118,7 +122,17 @@ LRMCascade * LRM_AllocCascade();
 void LRM_FillCascade(LRMCascade * casc,const U8 * buffer, SINTa bufSize, int step, int jumpBits_0, int jumpBits_inc,
 						SINTa base_chunkSize, int hash_length);
 
+// Append-only : buffer must be the same pointer the cascade was made on,
+//	newBufSize >= the old size ; only the new chunks are hashed
+void LRM_ExtendCascade(LRMCascade * casc, SINTa newBufSize);
+// Undo Extend : drop every LRM that reaches past newBufSize (rounded down to chunks)
+//	the result is the same as a cascade made on the shorter buffer
+void LRM_TruncateCascade(LRMCascade * casc, SINTa newBufSize);
+
 SINTa LRM_GetCascadeChunkSize(const LRMCascade * casc);
+const U8 * LRM_GetCascadeBuffer(const LRMCascade * casc);
+// end of the region the cascade covers (once filled)
+const U8 * LRM_GetCascadeEndPtr(const LRMCascade * casc);
 
 struct LRMSet
 {
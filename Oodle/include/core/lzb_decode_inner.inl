@@ -53,7 +53,7 @@
 				RR_ASSERT( rp+lrl <= rpEnd );
 				RR_ASSERT( cp+lrl <= comp_end );
 				
-				copy_no_overlap_long(rp,cp,lrl);
+				copy_no_overlap16_long(rp,cp,lrl);
 				
 				rp += lrl;
 				cp += lrl;
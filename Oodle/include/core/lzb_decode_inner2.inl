@@ -248,8 +248,11 @@
 					
 					RR_ASSERT( rp+ml <= rpEnd );
 					
-					// 8-byte copier :
-					copy_no_overlap_long(rp,match,ml);
+					// offset >= 8 on valid streams ; take 16 at a time when we can
+					if ( myoff >= 16 )
+						copy_no_overlap16_long(rp,match,ml);
+					else
+						copy_no_overlap_long(rp,match,ml);
 					rp += ml;
 					#else // DO_FAST_PATH
 					if_unlikely ( ml >= rpEnd - rp ) // match _touching_ rpEnd is not allowed (exclusion zone)
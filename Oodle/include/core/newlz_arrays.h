@@ -15,6 +15,7 @@ OODLE_NS_START
 
 struct rrArenaAllocator;
 struct OodleSpeedFit;
+struct newlz_huff_table_cache;
 
 /**
 
@@ -35,13 +36,15 @@ entropy_flags specify allowed optional features (NEWLZ_ARRAY_FLAG_*)
 SINTa newLZ_put_array_histo(U8 * to,U8 * to_end, const U8 * from, SINTa from_len, 
 							const U32 * histogram, U32 entropy_flags, 
 							F32 lambda,const OodleSpeedFit * speedfit, F32 * pJ, F32 deadline_t,
-							rrArenaAllocator * arena, int compression_level);
+							rrArenaAllocator * arena, int compression_level,
+							const newlz_huff_table_cache * huff_cache = NULL);
 
 SINTa newLZ_put_array(U8 * to,U8 * to_end, const U8 * from, SINTa from_len,
 	U32 entropy_flags, F32 lambda,const OodleSpeedFit * speedfit, F32 * pJ, F32 deadline_t,
 	rrArenaAllocator * arena,
 	int compression_level, // OodleLZ_CompressionLevel
-	U32 * optional_histo);
+	U32 * optional_histo,
+	const newlz_huff_table_cache * huff_cache = NULL);
 
 SINTa newLZ_put_array_uncompressed(U8 * to,U8 * to_end, const U8 * from, SINTa from_len);
 
@@ -86,7 +89,9 @@ fills *pto_len with raw len
 // these are in the .inl :
 
 static SINTa newLZ_get_array(U8ptr * ptr_to, const U8 * from, const U8 * from_end, SINTa * pto_len, SINTa to_len_max,
-								bool force_copy_uncompressed);
+								bool force_copy_uncompressed,
+								U8 * scratch_ptr, U8 * scratch_end,
+								newlz_huff_table_cache * huff_cache = NULL);
 
 */
 
@@ -94,9 +99,11 @@ static SINTa newLZ_get_array(U8ptr * ptr_to, const U8 * from, const U8 * from_en
 SINTa newLZ_get_arraylens(const U8 * from, const U8 * from_end, SINTa * pto_len, SINTa to_len_max);
 
 SINTa newLZ_get_array_comp(U32 array_type, U8ptr * ptr_to, const U8 * from, const U8 * from_end, SINTa * pto_len, SINTa to_len_max,
-								U8 * scratch_ptr, U8 * scratch_end);
+								U8 * scratch_ptr, U8 * scratch_end,
+								newlz_huff_table_cache * huff_cache = NULL);
 
-SINTa newlz_get_array_huff(const U8 * const comp, SINTa comp_len, U8 * const to, SINTa to_len, bool is_huff6);
+SINTa newlz_get_array_huff(const U8 * const comp, SINTa comp_len, U8 * const to, SINTa to_len, bool is_huff6,
+								newlz_huff_table_cache * huff_cache = NULL);
 
 // NEWLZ_ARRAY_TYPE_ is 3 bits
 //
@@ -122,7 +129,8 @@ SINTa newlz_get_array_huff(const U8 * const comp, SINTa comp_len, U8 * const to,
 #define NEWLZ_ARRAY_TYPE_TANS			1	// Oodle >= 2.6.0
 #define NEWLZ_ARRAY_TYPE_RLE			3	// Oodle >= 2.6.0
 #define NEWLZ_ARRAY_TYPE_SPLIT			5	// Oodle >= 2.6.0
-#define NEWLZ_ARRAY_TYPE_COUNT			6
+#define NEWLZ_ARRAY_TYPE_RANS			6	// opt-in, see NEWLZ_RANS_MIN_MAJOR_VERSION
+#define NEWLZ_ARRAY_TYPE_COUNT			7
 // we run out at 8
 
 #define NEWLZ_ARRAY_SIZE_BITS	18
@@ -142,6 +150,18 @@ SINTa newlz_get_array_huff(const U8 * const comp, SINTa comp_len, U8 * const to,
 #define NEWLZ_ARRAY_FLAG_ALLOW_RLE_MEMSET   (1<<7)	// allow using RLE special case for memset arrays
 	// RLEHUFF is implicitly disallowed when _RLE is off
 	//	but _RLE_MEMSET is *not* , it can be on even with _RLE is off
+#define NEWLZ_ARRAY_FLAG_ALLOW_RANS		(1<<8)	// 32-way interleaved rANS (NEWLZ_ARRAY_TYPE_RANS)
+
+// rANS arrays are never emitted by default
+//	they are only allowed when g_OodleLZ_BackwardsCompatible_MajorVersion is set >= this
+//	decoders that predate NEWLZ_ARRAY_TYPE_RANS see array_type >= their NEWLZ_ARRAY_TYPE_COUNT and fail cleanly
+#define NEWLZ_RANS_MIN_MAJOR_VERSION	10
+
+#define NEWLZ_ARRAY_FLAG_ALLOW_HUFF_REUSE	(1<<9)	// huff arrays may reuse a table sent earlier in the chunk
+
+// huff table reuse is opt-in the same way as rANS
+//	the reuse is signalled with the "11" huff header flag that older decoders reject as corrupt
+#define NEWLZ_HUFF_REUSE_MIN_MAJOR_VERSION	10
 
 
 // size can be up to MASK+1
@@ -35,13 +35,17 @@ scratch is for get_array to use internally for its temp memory needs
 (which is very very common)
 in which case get_array will internally advance scratch_ptr by to_len
 
+huff_cache is optional ; when given, huff arrays add their tables to it
+and may reuse a table from an earlier array (NEWLZ_ARRAY_FLAG_ALLOW_HUFF_REUSE)
+
 **/
 				
 // newLZ_get_array : returns comp len ; fills *pto_len
 //		passed "from_len" should be the array size
 static RADINLINE SINTa newLZ_get_array(U8ptr * ptr_to, const U8 * from, const U8 * from_end, SINTa * pto_len, SINTa to_len_max,
 								bool force_copy_uncompressed,
-								U8 * scratch_ptr, U8 * scratch_end)
+								U8 * scratch_ptr, U8 * scratch_end,
+								newlz_huff_table_cache * huff_cache = NULL)
 {
 	RR_ASSERT( ptr_to != NULL );
 
@@ -169,7 +173,7 @@ static RADINLINE SINTa newLZ_get_array(U8ptr * ptr_to, const U8 * from, const U8
 		}
 	}
 	
-	return newLZ_get_array_comp(array_type, ptr_to, from, from_end, pto_len, to_len_max, scratch_ptr, scratch_end);
+	return newLZ_get_array_comp(array_type, ptr_to, from, from_end, pto_len, to_len_max, scratch_ptr, scratch_end, huff_cache);
 }
 
 static RADINLINE U8 * newLZ_put_array_uncomp_header(U8 * to_ptr, SINTa from_len)
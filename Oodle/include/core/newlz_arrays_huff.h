@@ -13,6 +13,48 @@ OODLE_NS_START
 
 #define NEWLZ_HUFF6_MIN_SIZE	256		// don't bother with huff6 if stream is shorter than this
 
+// Un-bit-reversed huff table in MSB-first decode order, used in building the real KrakenHuffTab
+struct KrakenMSBHuffTab
+{
+	U8 len[NEWLZ_HUFF_DECODE_TABLE_SIZE + 16]; // code lens; +16 for sloppy memset
+	U8 sym[NEWLZ_HUFF_DECODE_TABLE_SIZE + 16]; // sym id; +16 for sloppy memset
+};
+
+/**
+
+newlz_huff_table_cache :
+
+the huff tables sent so far in a chunk (NEWLZ_ARRAY_FLAG_ALLOW_HUFF_REUSE)
+
+a huff header of "11" + 2 bit slot says "decode with cached table [slot]"
+	instead of sending code lens
+
+every top level huff array that sends its own code lens (with more than one symbol)
+	is added to the cache in bitstream order until it's full
+the encoder adds its committed arrays with newlz_huff_table_cache_add_array
+	which parses them the same way the decoder does, so the two caches always match
+
+the format has room for 4 slots ; we only keep 2 to keep the decoder stack use down
+
+**/
+
+#define NEWLZ_HUFF_TABLE_CACHE_SIZE	2
+
+struct newlz_huff_table_cache
+{
+	int count;
+	KrakenMSBHuffTab tables[NEWLZ_HUFF_TABLE_CACHE_SIZE];
+};
+
+static RADINLINE void newlz_huff_table_cache_init(newlz_huff_table_cache * cache)
+{
+	cache->count = 0;
+}
+
+// add the table of the array at [array_comp] to the cache, if it's a huff array that sent one
+//	array_comp points at the newlz_array header
+void newlz_huff_table_cache_add_array(newlz_huff_table_cache * cache, const U8 * array_comp, const U8 * array_comp_end);
+
 
 // kind of nasty two different failure return values ;
 //	either -1 or from_len+1 for failure ; WTF me
@@ -27,7 +69,18 @@ SINTa newLZ_put_array_huff(U8 * const to, U8 * const to_end, const U8 * const fr
 									rrArenaAllocator * arena,
 									int compression_level);
 // huff_type == NEWLZ_ARRAY_TYPE_HUFF6 or NEWLZ_ARRAY_TYPE_HUFF
+
+// newLZ_put_array_huff_reuse : try coding with one of the tables in huff_cache
+//	same return conventions as newLZ_put_array_huff
+SINTa newLZ_put_array_huff_reuse(U8 * const to, U8 * const to_end, const U8 * const from, SINTa from_len, 
+									const U32 * histogram,
+									F32 lambda, const OodleSpeedFit * speedfit, F32 * pJ /* readwrite */, F32 deadline_t,
+									U32 * p_huff_type, 
+									U32 entropy_flags,
+									const newlz_huff_table_cache * huff_cache,
+									rrArenaAllocator * arena);
 									
-SINTa newlz_get_array_huff(const U8 * const comp, SINTa comp_len, U8 * const to, SINTa to_len, bool is_huff6);
+SINTa newlz_get_array_huff(const U8 * const comp, SINTa comp_len, U8 * const to, SINTa to_len, bool is_huff6,
+									newlz_huff_table_cache * huff_cache);
 
 OODLE_NS_END
@@ -0,0 +1,68 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+// This source file is licensed solely to users who have
+// accepted a valid Unreal Engine license agreement 
+// (see e.g., https://www.unrealengine.com/eula), and use
+// of this source file is governed by such agreement.
+
+#pragma once
+
+#include "rrbase.h"
+#include "newlz_arrays.h"
+
+OODLE_NS_START
+
+/**
+
+newlz rANS arrays (NEWLZ_ARRAY_TYPE_RANS)
+
+static model, 12 bit probabilities
+32 interleaved 32-bit states, 16-bit word renormalization
+symbol i is coded by state (i%32)
+
+laid out so that a SIMD decoder can run 8 (AVX2) or 16 (AVX-512) states per vector
+and do the renorm word reads with a compaction shuffle, in the same order as the scalar decoder
+
+these are in the bitstream and can't change :
+
+**/
+
+#define NEWLZ_RANS_NUM_STATES		32
+#define NEWLZ_RANS_SCALE_BITS		12
+#define NEWLZ_RANS_SCALE			(1<<NEWLZ_RANS_SCALE_BITS)
+#define NEWLZ_RANS_L				(1U<<16)
+
+// the state flush is 128 bytes, so tiny arrays can never win
+#define NEWLZ_RANS_ARRAY_MIN_SIZE	2048
+
+// < 0 means failure and [to] was not modified
+SINTa newLZ_put_array_rans(U8 * const to, U8 * const to_end, const U8 * const from, SINTa from_len,
+									const U32 * histogram,
+									F32 lambda, const OodleSpeedFit * speedfit, F32 *pJ,
+									rrArenaAllocator * arena);
+
+SINTa newlz_get_array_rans(const U8 * const comp, SINTa comp_len, U8 * const to, SINTa to_len, U8 * scratch_ptr, U8 * scratch_end);
+
+//=============================================================
+
+// decode table entry is (freq-1) | ((slot - cumfreq)<<12) | (sym<<24)
+//	x' = freq * (x>>12) + (x&4095) - cumfreq = (freq-1)*(x>>12) + (x>>12) + (slot - cumfreq)
+
+struct KrakenRansState
+{
+	const U32 * table;	// [NEWLZ_RANS_SCALE] decode table
+
+	// output ; kernels only do whole groups of NEWLZ_RANS_NUM_STATES
+	U8 * decodeptr;
+	U8 * decodeend;
+
+	// renorm words, 16-bit LE, read forward
+	const U8 * wordp;
+	const U8 * wordend;
+
+	U32 rans_state[NEWLZ_RANS_NUM_STATES];
+};
+
+bool newlz_rans_decode_finish(KrakenRansState * s);
+bool newlz_rans_decode_avx2(KrakenRansState * s); // x86
+
+OODLE_NS_END
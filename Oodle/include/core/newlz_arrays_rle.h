@@ -21,4 +21,13 @@ SINTa newLZ_put_array_rle(U8 * const to, U8 * const to_end, const U8 * const fro
 // Returns comp_len on success, -1 on failure.
 SINTa newLZ_get_array_rle(const U8 * const comp, SINTa comp_len, U8 * const to, SINTa to_len, U8 * scratch_ptr, U8 * scratch_end);
 
+// x86 AVX2 kernels, selected at runtime with newlz_simd_has_avx2_bulk :
+
+// RLE7 encoder parse loop (newlz_arrays_rle_encode.inl) with 32-byte run searches ; output is identical
+bool newLZ_rle7_parse_avx2(const U8 * in_safe_end, const U8 * in_end, const U8 ** p_lit_start, U8 ** p_litp, U8 ** p_pktp, U8 * p_last_v);
+
+// decoder long RL / long LRL packets ; these write exactly [to,to+len)
+void newLZ_rle7_fill_run_avx2(U8 * to, U8 run_val, SINTa len);		// len >= 128
+void newLZ_rle7_copy_lits_avx2(U8 * to, const U8 * from, SINTa len);	// len >= 64
+
 OODLE_NS_END
@@ -0,0 +1,238 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+// This source file is licensed solely to users who have
+// accepted a valid Unreal Engine license agreement 
+// (see e.g., https://www.unrealengine.com/eula), and use
+// of this source file is governed by such agreement.
+
+/**
+
+RLE7 encoder main parse loop, shared between the SSE2/NEON/scalar build and the AVX2 build
+
+before including, define :
+
+	RLE7_PARSE_NAME	- name of the parse function to generate
+	RLE7_PARSE_LINKAGE - optional, eg. static
+
+and provide :
+
+	rle7_skip_to_next_run3(in_ptr, in_safe_end)
+	rle7_find_run_end(run_ptr, in_safe_end, in_end)
+	rle7_copy_literals_sloppy(litp, lit_start, lrl)
+
+the run searches must find exactly the same runs in every build, so the output is identical
+
+**/
+
+#ifndef RLE7_PARSE_NAME
+#error define RLE7_PARSE_NAME
+#endif
+
+#ifndef RLE7_PARSE_LINKAGE
+#define RLE7_PARSE_LINKAGE
+#endif
+
+#ifndef NEWLZ_ARRAYS_RLE_ENCODE_EMITTERS
+#define NEWLZ_ARRAYS_RLE_ENCODE_EMITTERS
+
+// Emits one or two simple packets. You need to check whether that fits before you call!
+static RADFORCEINLINE U8 *rle7_emit_short_packets(U8 *pktp, U8 *litp, UINTa lrl, UINTa rl)
+{
+	RR_ASSERT(pktp - litp >= 2); // this function will emit at most 2 bytes.
+	RR_ASSERT(rl >= 3);
+	(void)litp; // shut up warnings
+
+	if (lrl <= 15)
+	{
+		if (rl <= 15)
+			*--pktp = static_cast<U8>((rl << 4) | (15 - lrl));
+		else
+		{
+			RR_ASSERT(rl <= 30);
+
+			// Neither packet may have a run length below 3, so just split the run in half.
+			UINTa lo_rl = rl >> 1;
+			UINTa hi_rl = rl - lo_rl;
+
+			*--pktp = static_cast<U8>((lo_rl << 4) | (15 - lrl));
+			*--pktp = static_cast<U8>((hi_rl << 4) | 15);
+		}
+	}
+	else
+	{
+		RR_ASSERT(lrl <= 30 && rl <= 15);
+		*--pktp = 0x00; // rl=0, lrl=15
+		*--pktp = static_cast<U8>((rl << 4) | (15 - (lrl - 15)));
+	}
+
+	return pktp;
+}
+
+// Returns NULL if we run out of output space.
+static RADFORCEINLINE U8 *rle7_emit_long_packet(U8 *pktp, U8 *litp, UINTa lrl, UINTa rl)
+{
+	// Required safety margin for the common cases, long LRL/RL can check every iter (they're rare)
+	static const SINTa kMiddleMaxBytes = 2; // max bytes for middle part (medium packet)
+	RR_ASSERT(pktp - litp >= 1 + kMiddleMaxBytes); // simple packet in front (next if)
+
+	// If we're just slightly above 63, it's better to use a simple packet to get us below than to send a long LRL packet
+	if (lrl >= 64 && lrl < 79)
+	{
+		// NOTE this packet priced into safety margin above
+		*--pktp = 0x00; // rl=0, lrl=15
+		lrl -= 15;
+	}
+
+	// long LRL
+	while (lrl >= 64)
+	{
+		static const UINTa kMaxValLRL = 7*256;
+		U32 lrl_this_run = static_cast<U32>(RR_MIN(lrl >> 6, kMaxValLRL));
+		RR_ASSERT(lrl_this_run >= 1);
+
+		// long LRL not priced into safety margin above, need to check whether this packet puts us below
+		// the required number of bytes for the middle packet.
+		if (pktp - litp < kMiddleMaxBytes + 2)
+			return NULL;
+
+		U32 v = lrl_this_run - 1;
+		*--pktp = static_cast<U8>(2 + (v >> 8));
+		*--pktp = (U8)v; // & 0xff;
+
+		lrl -= lrl_this_run << 6;
+	}
+
+	// Middle part
+	RR_ASSERT(pktp - litp >= kMiddleMaxBytes);
+	UINTa rl_rem = rl & 0x7f;
+	if (rl_rem < 3 || lrl > 30 || (rl_rem > 15 && lrl > 15) || rl_rem > 30) // NOTE(fg): more than two simple packets for the remainder
+	//if (rl_rem < 3 || lrl > 15 || rl_rem > 15) // NOTE(fg): more than one simple packet for the remainder
+	{
+		// Don't emit middle packet if LRL and RL are both 0!
+		// This is an optimization but it's important when a stream ends with a multiple of 64 literals;
+		// the extra lrl=0 rl=0 medium-length packet occurs after all bytes have been decoded, which is
+		// not allowed.
+		if ((lrl | rl_rem) != 0)
+		{
+			// medium packet
+			U32 v = static_cast<U32>(lrl | (rl_rem << 6));
+			*--pktp = static_cast<U8>((v >> 8) + 0x10);
+			*--pktp = (U8)v; // & 0xff;
+		}
+	}
+	else
+		pktp = rle7_emit_short_packets(pktp, litp, lrl, rl_rem);
+
+	// Long RL
+	while (rl >= 128)
+	{
+		static const UINTa kMaxValRL = 7*256;
+		U32 rl_this_run = static_cast<U32>(RR_MIN(rl >> 7, kMaxValRL));
+		RR_ASSERT(rl_this_run >= 1);
+
+		// Long RL not considered in safety margin, need to check on every packet (but that's fine)
+		if (pktp - litp < 2)
+			return NULL;
+
+		U32 v = rl_this_run - 1;
+		*--pktp = static_cast<U8>(9 + (v >> 8));
+		*--pktp = (U8)v; // & 0xff;
+
+		rl -= rl_this_run << 7;
+	}
+
+	return pktp;
+}
+
+#endif // NEWLZ_ARRAYS_RLE_ENCODE_EMITTERS
+
+// Parses [*p_lit_start,in_safe_end) ; *p_litp/*p_pktp are the two output streams, *p_last_v the current run value
+// on return *p_lit_start is the start of the pending literals
+// Returns false if we run out of output space.
+RLE7_PARSE_LINKAGE bool RLE7_PARSE_NAME(const U8 * in_safe_end, const U8 * in_end, const U8 ** p_lit_start, U8 ** p_litp, U8 ** p_pktp, U8 * p_last_v)
+{
+	// Min run len for us to consider sending a new run value
+	static const UINTa RLE7_MRL_NEWV = 8;
+
+	const U8 *lit_start = *p_lit_start;
+	const U8 *in_ptr = lit_start;
+	U8 *litp = *p_litp;
+	U8 *pktp = *p_pktp;
+	U8 last_v = *p_last_v;
+
+	while (in_ptr < in_safe_end)
+	{
+		// Skip over run-less regions quickly
+		in_ptr = rle7_skip_to_next_run3(in_ptr, in_safe_end);
+
+		// Don't even bother trying to find runs starting within the last few bytes of
+		// the input buffer; the benefit is small and not having to deal with it makes
+		// writing a fast encoder simpler.
+		if (in_ptr >= in_safe_end)
+			break;
+
+		// Determine run length starting at current byte.
+		// This returns the end of the run.
+		const U8 *run_end = rle7_find_run_end(in_ptr, in_safe_end, in_end);
+
+		// If long enough run, emit it!
+		U8 v = *in_ptr;
+		UINTa lrl = in_ptr - lit_start;
+		UINTa run_len = run_end - in_ptr;
+		in_ptr = run_end; // advance ptr whether we send the run or not
+
+		// We started by skipping ahead to the next len-3 run, so this run better be
+		// at least 3 bytes.
+		RR_ASSERT(run_len >= 3);
+
+		// We check for a little more output space than required. This allows us to do the
+		// literal copying sloppily, but it also accounts for the number of packet bytes we
+		// need to send later (see checks in emit_short_packets and emit_long_packet).
+		static const UINTa kSafetyMargin = 2 + 16; // 2 bytes for "change run value" packet, up to 16 slop for copy. (Which also guarantees min packet space.)
+		UINTa bytes_left = pktp - litp;
+		if (bytes_left < lrl + kSafetyMargin)
+			return false;
+
+		// If we change run value, make sure our run is long enough, and send the
+		// "change run value" packet.
+		if (v != last_v)
+		{
+			if (run_len < RLE7_MRL_NEWV)
+				continue;
+			*--pktp = 1; // "new run symbol" code
+			*litp++ = v;
+			last_v = v;
+		}
+
+		// Copy literals over
+		// NOTE kSafetyMargin above guarantees we can do this sloppily, as long
+		// as we're far away enough from the end of the input, which our in_ptr < in_safe_end
+		// checks above guarantee.
+		//
+		// Slop here is 16 not 15 because we can have lrl=0 (after changing run value)
+		// but we always copy at least 16 bytes.
+		RR_ASSERT(in_end - (lit_start + lrl) >= 16);
+
+		rle7_copy_literals_sloppy(litp, lit_start, lrl);
+		litp += lrl;
+		lit_start = in_ptr;
+
+		if (lrl > 30 || (run_len > 15 && lrl > 15) || run_len > 30) // NOTE(fg): more than two simple packets
+		//if (run_len > 15 || lrl > 15) // NOTE(fg): more than one simple packet
+		{
+			pktp = rle7_emit_long_packet(pktp, litp, lrl, run_len);
+			if (!pktp) // ran out of output space
+				return false;
+		}
+		else
+			pktp = rle7_emit_short_packets(pktp, litp, lrl, run_len);
+	}
+
+	*p_lit_start = lit_start;
+	*p_litp = litp;
+	*p_pktp = pktp;
+	*p_last_v = last_v;
+	return true;
+}
+
+#undef RLE7_PARSE_NAME
+#undef RLE7_PARSE_LINKAGE
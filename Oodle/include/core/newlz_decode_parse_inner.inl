@@ -142,22 +142,44 @@ NEWLZ !!
 						// If not, we screwed something up.
 						RR_ASSERT( lrl <= (match_zone_end - to_ptr) );
 
-						to_ptr += 24;
-						literals_ptr += 24;
-						lrl -= 24;
-
-						for (;;)
+						#if NEWLZ_DECODE_COPY32
+						#if NEWLZ_DECODE_LITERALS_TYPE == NEWLZ_LITERALS_TYPE_SUB
+						if ( lrl >= 32 && neg_offset <= -64 )
+						#else
+						if ( lrl >= 32 )
+						#endif
 						{
-							// do a copy-16 loop here? tried it, no big wins; long lrl is already fast
-							newlz_literals_copy8<NEWLZ_DECODE_LITERALS_TYPE>(to_ptr,to_ptr+neg_offset,literals_ptr);
-
-							CHECK( RR_ASSERT( memcmp(to_ptr,check_ptr,RR_MIN(8,lrl)) == 0 ); RR_DURING_ASSERT( check_ptr += RR_MIN(8,lrl) ) );
-
-							to_ptr += 8;
-							literals_ptr += 8;
-							lrl -= 8;
-							if ( lrl <= 0 )
-								break;
+							// 24 done ; the last step backs up over them to end exactly at to_ptr+lrl
+							CHECK( RR_DURING_ASSERT( check_ptr += lrl-24 ) );
+							#if NEWLZ_DECODE_LITERALS_TYPE == NEWLZ_LITERALS_TYPE_SUB
+							newlz_literals_sub32_to_end(to_ptr+24,neg_offset,literals_ptr+24,to_ptr+lrl);
+							#else
+							newlz_copy32_to_end(to_ptr+24,literals_ptr+24,to_ptr+lrl);
+							#endif
+							to_ptr += lrl;
+							literals_ptr += lrl;
+							lrl = 0;
+						}
+						else
+						#endif
+						{
+							to_ptr += 24;
+							literals_ptr += 24;
+							lrl -= 24;
+
+							for (;;)
+							{
+								// do a copy-16 loop here? tried it, no big wins; long lrl is already fast
+								newlz_literals_copy8<NEWLZ_DECODE_LITERALS_TYPE>(to_ptr,to_ptr+neg_offset,literals_ptr);
+
+								CHECK( RR_ASSERT( memcmp(to_ptr,check_ptr,RR_MIN(8,lrl)) == 0 ); RR_DURING_ASSERT( check_ptr += RR_MIN(8,lrl) ) );
+
+								to_ptr += 8;
+								literals_ptr += 8;
+								lrl -= 8;
+								if ( lrl <= 0 )
+									break;
+							}
 						}
 					}
 				}
@@ -231,22 +253,31 @@ NEWLZ !!
 		
 			RR_ASSERT_IF_NOT_CORRUPT( -neg_offset >= 8 );
 						
-			// ml >= 17 , so I can copy 24 to start :
 			U8 * to_ptr_end = to_ptr+ml;			
-			lz_copy8(to_ptr,mp);
-			lz_copy8(to_ptr+8,mp+8);
-			lz_copy8(to_ptr+16,mp+16);
-			to_ptr += 24; mp += 24;
-			
-			if ( to_ptr < to_ptr_end )
+			#if NEWLZ_DECODE_COPY32
+			if ( ml >= 32 && neg_offset <= -64 )
+			{
+				newlz_copy32_to_end(to_ptr,mp,to_ptr_end);
+			}
+			else
+			#endif
 			{
-				// ML > 24			
-				// basic loop does 8-at-a-time copies
-				//	with sloppy tail
-				// have tried rolling up to bigger copy steps here, but no win, long matches are already fast		
+				// ml >= 17 , so I can copy 24 to start :
+				lz_copy8(to_ptr,mp);
+				lz_copy8(to_ptr+8,mp+8);
+				lz_copy8(to_ptr+16,mp+16);
+				to_ptr += 24; mp += 24;
 				
-				do { lz_copy8(to_ptr,mp); to_ptr += 8; mp += 8; }
-				while( to_ptr < to_ptr_end );
+				if ( to_ptr < to_ptr_end )
+				{
+					// ML > 24			
+					// basic loop does 8-at-a-time copies
+					//	with sloppy tail
+					// have tried rolling up to bigger copy steps here, but no win, long matches are already fast		
+					
+					do { lz_copy8(to_ptr,mp); to_ptr += 8; mp += 8; }
+					while( to_ptr < to_ptr_end );
+				}
 			}
 			to_ptr = to_ptr_end;
 
@@ -122,6 +122,8 @@ static RADNOINLINE bool newLZ_decode_parse(
 			literals_end = literals_check = literal_scratch + kLitsPerCheckpoint; \
 		} while (0)
 		
+		// no software prefetch of far match sources ; see newLZ_decode_parse_func in newlz_decoder.h
+
 		// main loop that runs while we're far enough away from the end
 		while (packets < packets_end && to_ptr < output_safe_end)
 		{
@@ -73,6 +73,11 @@ static inline const U8 * ptr_sub_saturate( const U8 * ptr, SINTa sub_amount, con
 	return ( ptr - base ) < sub_amount ? base : ptr - sub_amount;
 }
 
+// The decode_parse loops (Kraken & Leviathan) don't software prefetch far match sources :
+//	a walker running 32 packets ahead and prefetching new offsets beyond 256 KB was 1% slower
+//	on its own and 8-26% slower with the prefetches (x64, 2 MB L2, 32-256 MB windows of random
+//	far matches).  The far loads don't depend on each other, so OoO already overlaps them ;
+//	prefetches just take fill buffers.
 typedef bool newLZ_decode_parse_func(
 	const newLZ_chunk_arrays * arrays,
 	U8 * to_ptr, U8 * chunk_base, U8 * chunk_end, U8 * window_base );
@@ -87,5 +92,26 @@ struct newLZ_decode_parse_func_set
 extern const newLZ_decode_parse_func_set newLZ_decode_parse_funcs_sse4;
 #endif
 
+#ifdef DO_BUILD_AVX2
+extern const newLZ_decode_parse_func_set newLZ_decode_parse_funcs_avx2;
+#endif
+
+/**
+
+NEWLZ_DECODE_COPY32 : the long LRL (> 24) and long ML (excess) paths of the decode_parse
+	copy in 32 byte steps when the run is >= 32 and the offset is >= 64 (raw literals don't
+	need the offset check) ; the check is made once per run, not per step
+	the last step is aligned to the end of the run, so nothing is written past it
+	offsets 32-63 stay on the 8 byte steps : each 32 byte load then reads the stores just
+	made, which don't forward ; a short period file decoded 3% slower with them on 32 byte steps
+
+only the AVX2 decoder (newlz_avx2.cpp) turns this on
+
+**/
+
+#ifndef NEWLZ_DECODE_COPY32
+#define NEWLZ_DECODE_COPY32	0
+#endif
+
 OODLE_NS_END
 
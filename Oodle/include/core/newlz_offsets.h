@@ -230,6 +230,7 @@ bool newLZ_offset44_decode_finish(KrakenOffsetState * s);
 bool newLZ_offset44_decode64_tab(KrakenOffsetState * s);
 bool newLZ_offset44_decode_sse4(KrakenOffsetState * s); // x86
 bool newLZ_offset44_decode_avx2(KrakenOffsetState * s); // x86
+bool newLZ_offset44_decode_avx512(KrakenOffsetState * s); // x86
 bool newLZ_offset44_decode_neon(KrakenOffsetState * s); // ARM only
 bool newLZ_offset44_decode_arm64(KrakenOffsetState * s); // ARM64 only
 
@@ -352,6 +353,7 @@ bool newLZ_offsetalt_decode_finish(KrakenOffsetState * s);
 bool newLZ_offsetalt_decode64_tab(KrakenOffsetState * s);
 bool newLZ_offsetalt_decode_sse4(KrakenOffsetState * s); // x86 only
 bool newLZ_offsetalt_decode_avx2(KrakenOffsetState * s); // x86 only
+bool newLZ_offsetalt_decode_avx512(KrakenOffsetState * s); // x86 only
 bool newLZ_offsetalt_decode_neon(KrakenOffsetState * s); // ARM only
 bool newLZ_offsetalt_decode_arm64(KrakenOffsetState * s); // ARM64 only
 
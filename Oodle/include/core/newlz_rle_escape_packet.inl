@@ -58,27 +58,37 @@
   				NEWLZ_ARRAY_RETURN_FAILURE();
   			}
 
-			// write last 64 bytes precisely, plus one 16b block at the
-			// start to get us to alignment
-			write128(outp, runv);
-			U8 *outp_a = (U8 *)(((UINTa)outp + 15) & ~15);
-
-			outp += rl;
-			write128(outp - 0x40, runv);
-			write128(outp - 0x30, runv);
-			write128(outp - 0x20, runv);
-			write128(outp - 0x10, runv);
-
-			// write rest aligned
-			U8 *outp_end = outp - 0x40;
-			do
+			#ifdef RLE7_AVX2_BULK_DECODE
+			if ( use_avx2 )
 			{
-				write128a(outp_a + 0x00, runv);
-				write128a(outp_a + 0x10, runv);
-				write128a(outp_a + 0x20, runv);
-				write128a(outp_a + 0x30, runv);
-				outp_a += 0x40;
-			} while (outp_a < outp_end);
+				newLZ_rle7_fill_run_avx2(outp, firstb_128(runv), rl);
+				outp += rl;
+			}
+			else
+			#endif
+			{
+				// write last 64 bytes precisely, plus one 16b block at the
+				// start to get us to alignment
+				write128(outp, runv);
+				U8 *outp_a = (U8 *)(((UINTa)outp + 15) & ~15);
+
+				outp += rl;
+				write128(outp - 0x40, runv);
+				write128(outp - 0x30, runv);
+				write128(outp - 0x20, runv);
+				write128(outp - 0x10, runv);
+
+				// write rest aligned
+				U8 *outp_end = outp - 0x40;
+				do
+				{
+					write128a(outp_a + 0x00, runv);
+					write128a(outp_a + 0x10, runv);
+					write128a(outp_a + 0x20, runv);
+					write128a(outp_a + 0x30, runv);
+					outp_a += 0x40;
+				} while (outp_a < outp_end);
+			}
 		}
 		else /*if (packet >= 0x02)*/ // long LRL (only code left)
 		{
@@ -93,34 +103,45 @@
   				NEWLZ_ARRAY_RETURN_FAILURE();
   			}
 
-			// write first 16 bytes precisely
-			write128(outp, read128(lits));
-
-			// get to 16-byte output alignment
-			UINTa align_amt = (0 - UINTa(outp)) & 15;
-			U8 *outp_a = outp + align_amt;
-			const U8 *lits_a = lits + align_amt;
-
-			// now write remaining 48 bytes of first block aligned
-			write128a(outp_a + 0x00, read128(lits_a + 0x00));
-			write128a(outp_a + 0x10, read128(lits_a + 0x10));
-			write128a(outp_a + 0x20, read128(lits_a + 0x20));
-
-			// aligned bulk loop
-			while (--v)
+			#ifdef RLE7_AVX2_BULK_DECODE
+			if ( use_avx2 )
 			{
-				write128a(outp_a + 0x30, read128(lits_a + 0x30));
-				write128a(outp_a + 0x40, read128(lits_a + 0x40));
-				write128a(outp_a + 0x50, read128(lits_a + 0x50));
-				write128a(outp_a + 0x60, read128(lits_a + 0x60));
-				outp_a += 0x40;
-				lits_a += 0x40;
+				newLZ_rle7_copy_lits_avx2(outp, lits, lrl);
+				outp += lrl;
+				lits += lrl;
+			}
+			else
+			#endif
+			{
+				// write first 16 bytes precisely
+				write128(outp, read128(lits));
+
+				// get to 16-byte output alignment
+				UINTa align_amt = (0 - UINTa(outp)) & 15;
+				U8 *outp_a = outp + align_amt;
+				const U8 *lits_a = lits + align_amt;
+
+				// now write remaining 48 bytes of first block aligned
+				write128a(outp_a + 0x00, read128(lits_a + 0x00));
+				write128a(outp_a + 0x10, read128(lits_a + 0x10));
+				write128a(outp_a + 0x20, read128(lits_a + 0x20));
+
+				// aligned bulk loop
+				while (--v)
+				{
+					write128a(outp_a + 0x30, read128(lits_a + 0x30));
+					write128a(outp_a + 0x40, read128(lits_a + 0x40));
+					write128a(outp_a + 0x50, read128(lits_a + 0x50));
+					write128a(outp_a + 0x60, read128(lits_a + 0x60));
+					outp_a += 0x40;
+					lits_a += 0x40;
+				}
+
+				outp += lrl;
+				lits += lrl;
+
+				// write last 16 bytes precisely
+				write128(outp - 0x10, read128(lits - 0x10));
 			}
-
-			outp += lrl;
-			lits += lrl;
-
-			// write last 16 bytes precisely
-			write128(outp - 0x10, read128(lits - 0x10));
 		}
 
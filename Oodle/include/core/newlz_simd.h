@@ -36,6 +36,11 @@
 #define DO_BUILD_AVX2
 #endif
 
+// AVX-512 kernels need AVX2 too
+#if defined(DO_BUILD_AVX2) && ! defined(__RADNOAVX512__)
+#define DO_BUILD_AVX512
+#endif
+
 // always build SSE4
 #define DO_BUILD_SSE4
 
@@ -134,6 +139,58 @@ static rrbool newlz_simd_has_avx2()
 
 #endif
 
+// newlz_simd_has_avx2_bulk : for kernels that do a lot of work per call
+//	(whole entropy arrays and the like), where the AVX2 power state transition
+//	is amortized ; those detect AVX2 at runtime on the desktop platforms
+//	newlz_simd_has_avx2 above stays the conservative switch for everything else
+
+#if defined(DO_AVX2_ALWAYS)
+
+static rrbool newlz_simd_has_avx2_bulk()
+{
+	return true;
+}
+
+#elif defined(DO_SSE4_TEST) && defined(DO_BUILD_AVX2)
+
+#define DO_AVX2_TEST
+
+static rrbool newlz_simd_has_avx2_bulk()
+{
+	return rrCPUx86_all_features_present(RRX86_CPU_AVX2|RRX86_CPU_BMI2);
+}
+
+#else
+
+static rrbool newlz_simd_has_avx2_bulk()
+{
+	return false;
+}
+
+#endif
+
+// newlz_simd_has_avx512_bulk : AVX-512 F/BW/VL/VBMI/VBMI2 (RRX86_CPU_AVX512)
+//	same rules as newlz_simd_has_avx2_bulk, only for kernels that do a lot of work per call
+//	no console target has it, so it's runtime detect or nothing
+
+#if defined(DO_AVX2_TEST) && defined(DO_BUILD_AVX512)
+
+#define DO_AVX512_TEST
+
+static rrbool newlz_simd_has_avx512_bulk()
+{
+	return rrCPUx86_all_features_present(RRX86_CPU_AVX512);
+}
+
+#else
+
+static rrbool newlz_simd_has_avx512_bulk()
+{
+	return false;
+}
+
+#endif
+
 //=========
 /**
 
@@ -158,6 +215,10 @@ S32 simd_dotproduct_s16_s16_256(const S16 * v1, const S16 * v2);
 S32 simd_dotproduct_s32_s16_256(const S32 * v1, bool v1_fits_in_S16, const S16 * v2);
 S32 simd_dotproduct_s32_s8_256( const S32 * v1, bool v1_fits_in_S16, const S8 * v2,int num);
 
+// AVX2 versions, called for you from the above if possible ; x86 only
+S32 simd_dotproduct_s16_s16_256_avx2(const S16 * v1, const S16 * v2);
+S32 simd_dotproduct_s32_s16_256_avx2(const S32 * v1, bool v1_fits_in_S16, const S16 * v2);
+
 S32 simd_horizontal_sum_s32(const S32 *v,int num);
 
 // offsets = offsets * multiplier - subtrahend
@@ -45,6 +45,7 @@ struct OodleSpeedFit
 	F32 (*huff6)(SINTa len, SINTa num_non_zero, SINTa num_alphabet_runs, F32 bpb);
 	F32 (*tans)(SINTa len, SINTa num_non_zero, SINTa L);
 	F32 (*rle)(SINTa len);
+	F32 (*rans)(SINTa len, SINTa num_non_zero);
 
 	// Packet parse
 	F32 (*parse_Selkie)(SINTa chunk_len, SINTa num_packets, SINTa num_escapes, SINTa num_literals);
@@ -54,6 +54,10 @@ IncrementalMatchFinder *(t_create_match_finder)(const U8 * ubuf,
 		OodleLZ_Jobify jobify,
 		void * jobifyUserPtr);
 
+typedef
+bool (t_create_match_finder_runs_jobs)(SINTa size,
+		OodleLZ_Jobify jobify);
+
 typedef
 void (t_free_matcher)(void * matcher);
 
@@ -184,6 +188,7 @@ struct newlz_vtable
 	U32 entropy_flags;
 	U32 bitstream_flags;
 	bool wants_dic_limit_splits;
+	t_create_match_finder_runs_jobs * fp_create_match_finder_runs_jobs; // optional ; true if fp_create_match_finder waits on its own jobs at this size, so can't run as an async job itself
 	bool try_huff_chunks;
 
 	int decodeType;
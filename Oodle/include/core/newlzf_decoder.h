@@ -134,6 +134,21 @@ NEWLZF_ML_EXCESS is NOT in the format, it's just an encoder-side parse choice tw
 
 #define newlzf_copy16(to,from)	lz_copy8(to,from); lz_copy8(to+8,from+8)
 
+/**
+
+NEWLZF_DECODE_COPY32 : the long escapes (LRL escape, long ML) copy in 32 byte steps
+	with newlzf_copy32 / newlzf_literals_sub32 when the offset is >= 32 ;
+	the offset check is made once per escape, not per step
+	the last step is aligned to the end of the run, so nothing is written past it
+
+only the AVX2 decoder (newlzf_avx2.cpp) turns this on
+
+**/
+
+#ifndef NEWLZF_DECODE_COPY32
+#define NEWLZF_DECODE_COPY32	0
+#endif
+
 #define NEWLZF_ONE_SIMPLE_PACKET(packet) do { \
 		RR_ASSERT( packet >= 24 ); \
 		int lrl = packet & 0x7; \
@@ -220,6 +235,38 @@ extern const U8 * newLZF_decode_parse_sub_sse4_first(
 	S32 * p_neg_offset
 	);
 	
+extern const U8 * newLZF_decode_parse_raw_avx2(
+	U8 * chunk_ptr, SINTa chunk_len, U8 * overrun_chunk_end,
+	U8 * window_base,
+	const U8 * comp_end,
+	newLZF_chunk_arrays * arrays,
+	S32 * p_neg_offset
+	);
+	
+extern const U8 * newLZF_decode_parse_sub_avx2(
+	U8 * chunk_ptr, SINTa chunk_len, U8 * overrun_chunk_end,
+	U8 * window_base,
+	const U8 * comp_end,
+	newLZF_chunk_arrays * arrays,
+	S32 * p_neg_offset
+	);
+	
+extern const U8 * newLZF_decode_parse_raw_avx2_first(
+	U8 * chunk_ptr, SINTa chunk_len, U8 * overrun_chunk_end,
+	U8 * window_base,
+	const U8 * comp_end,
+	newLZF_chunk_arrays * arrays,
+	S32 * p_neg_offset
+	);
+	
+extern const U8 * newLZF_decode_parse_sub_avx2_first(
+	U8 * chunk_ptr, SINTa chunk_len, U8 * overrun_chunk_end,
+	U8 * window_base,
+	const U8 * comp_end,
+	newLZF_chunk_arrays * arrays,
+	S32 * p_neg_offset
+	);
+	
 extern SINTa newlzf_unpack_escape_offsets_sse4(const U8 * comp_base, const U8 * comp_end,
 	U32 * offsets, SINTa offset_count , SINTa max_offset);
 
@@ -63,6 +63,15 @@
 			// this prevents overrunning output & input both
 			
 			#if NEWLZF_DECODE_LITERALS_TYPE == NEWLZ_LITERALS_TYPE_SUB
+			#if NEWLZF_DECODE_COPY32
+			if ( neg_offset <= -32 )
+			{
+				newlzf_literals_sub32_to_end(to_ptr,neg_offset,literals_ptr,to_ptr+lrl);
+				to_ptr += lrl;
+				literals_ptr += lrl;
+			}
+			else
+			#endif
 			{
 				// sub literals, need to check offset if you want to do longer copies
 						
@@ -84,6 +93,13 @@
 				// do last 8 :
 				newlz_literals_copy8<NEWLZF_DECODE_LITERALS_TYPE>(to_ptr-8,to_ptr-8+neg_offset,literals_ptr-8);		
 			}
+			#elif NEWLZF_DECODE_COPY32
+			{
+				// raw literals, no need to check offset
+				newlzf_copy32_to_end(to_ptr,literals_ptr,to_ptr+lrl);
+				to_ptr += lrl;
+				literals_ptr += lrl;
+			}
 			#else
 			{
 				// raw literals, no need to check offset
@@ -153,12 +169,21 @@
 		
 			RR_COMPILER_ASSERT( NEWLZF_ML_EXCESS > 64 );
 			
-			//do 64 :
-			RR_UNROLL_I_8(0, lz_copy8(to_ptr+i*8,mp+i*8); );
-			
-			to_ptr += 64; mp += 64;
+			#if NEWLZF_DECODE_COPY32
+			if ( neg_offset <= -32 )
+			{
+				newlzf_copy32_to_end(to_ptr,mp,to_ptr_end);
+			}
+			else
+			#endif
+			{
+				//do 64 :
+				RR_UNROLL_I_8(0, lz_copy8(to_ptr+i*8,mp+i*8); );
 				
-			lz_copy8steptoend(to_ptr,mp,to_ptr_end);
+				to_ptr += 64; mp += 64;
+					
+				lz_copy8steptoend(to_ptr,mp,to_ptr_end);
+			}
 			
 			to_ptr = to_ptr_end;
 			
@@ -204,19 +229,32 @@
 			// ml >= 29 ; I can go 16 past that (because of +16 above)
 			RR_COMPILER_ASSERT( 21 + NEWLZF_OFF24_MML_DECODE >= 29 );
 
-			//do 40 :
-			lz_copy8(to_ptr,mp);
-			lz_copy8(to_ptr+8,mp+8);
-			lz_copy8(to_ptr+16,mp+16);
-			lz_copy8(to_ptr+24,mp+24);
-			lz_copy8(to_ptr+32,mp+32);
-			//to_ptr += ml;
-			
-			if ( ml > 40 )
+			#if NEWLZF_DECODE_COPY32
+			if ( neg_offset <= -32 )
 			{
-				to_ptr += 40; mp += 40;
+				// ml >= 29, so one 32 byte copy stays in the +16 slack
+				if ( ml <= 32 )
+					newlzf_copy32(to_ptr,mp);
+				else
+					newlzf_copy32_to_end(to_ptr,mp,to_ptr_end);
+			}
+			else
+			#endif
+			{
+				//do 40 :
+				lz_copy8(to_ptr,mp);
+				lz_copy8(to_ptr+8,mp+8);
+				lz_copy8(to_ptr+16,mp+16);
+				lz_copy8(to_ptr+24,mp+24);
+				lz_copy8(to_ptr+32,mp+32);
+				//to_ptr += ml;
 				
-				lz_copy8steptoend(to_ptr,mp,to_ptr_end);
+				if ( ml > 40 )
+				{
+					to_ptr += 40; mp += 40;
+					
+					lz_copy8steptoend(to_ptr,mp,to_ptr_end);
+				}
 			}
 			to_ptr = to_ptr_end;
 			
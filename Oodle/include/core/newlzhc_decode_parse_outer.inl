@@ -220,6 +220,8 @@ static RADNOINLINE bool newLZHC_decode_parse(
 		//const U8 * output_safe_end = ptr_sub_saturate(chunk_end, kOutputPerCheckpoint + NEWLZHC_CHUNK_NO_MATCH_ZONE, chunk_base);
 		
 		
+		// no software prefetch of far match sources ; see newLZ_decode_parse_func in newlz_decoder.h
+
 		// main loop that runs while we're far enough away from the end
 		
 		{
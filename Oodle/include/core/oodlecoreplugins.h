@@ -116,6 +116,8 @@ The implementation makes either OodleCore_Plugin or OodleNet_Plugin
 #define t_fp_OodlePlugin_MallocAligned t_fp_OodleCore_Plugin_MallocAligned
 #define t_fp_OodlePlugin_Free t_fp_OodleCore_Plugin_Free
 #define OodlePlugins_SetAllocators OodleCore_Plugins_SetAllocators
+#define t_fp_OodlePlugin_MemoryHint t_fp_OodleCore_Plugin_MemoryHint
+#define OodlePlugins_SetMemoryHint OodleCore_Plugins_SetMemoryHint
 #define t_fp_OodlePlugin_Printf t_fp_OodleCore_Plugin_Printf
 #define OodlePlugins_SetPrintf OodleCore_Plugins_SetPrintf
 #define t_fp_OodlePlugin_DisplayAssertion t_fp_OodleCore_Plugin_DisplayAssertion
@@ -128,6 +130,7 @@ The implementation makes either OodleCore_Plugin or OodleNet_Plugin
 
 #define g_fp_OodlePlugin_MallocAligned g_fp_OodleCore_Plugin_MallocAligned
 #define g_fp_OodlePlugin_Free g_fp_OodleCore_Plugin_Free
+#define g_fp_OodlePlugin_MemoryHint g_fp_OodleCore_Plugin_MemoryHint
 #define g_fp_OodlePlugin_DisplayAssertion g_fp_OodleCore_Plugin_DisplayAssertion
 #define g_fp_OodlePlugin_Printf g_fp_OodleCore_Plugin_Printf
 
@@ -57,6 +57,63 @@ IDOC OOFUNC1 void OOFUNC2 OodleCore_Plugins_SetAllocators(
 
 */
 
+#define OODLE_MEMORY_HINT_LARGE_RANDOM_ACCESS	(1)	IDOC
+/* Flag for $t_fp_OodleCore_Plugin_MemoryHint : the block is a big table (match finder hash, suffix array)
+	that will be probed at random addresses, so it is dominated by TLB misses.  Backing it with large pages helps.
+*/
+
+#define OODLE_MEMORY_HINT_THREAD_LOCAL	(2)	IDOC
+/* Flag for $t_fp_OodleCore_Plugin_MemoryHint : the block is only used by the thread that allocated it
+	(eg. per-job tables in a jobified encode), so it should be placed on that thread's NUMA node.
+*/
+
+#define OODLE_MEMORY_HINT_WILL_READ	(4)	IDOC
+/* Flag for $t_fp_OodleCore_Plugin_MemoryHint : the block is compressed input that the decoder is about to read,
+	usually a slice of a memory-mapped file.  Start paging it in now so the decode doesn't stall on faults.
+	Not an allocation ; see $OodleLZ_DecompressReadAhead.
+*/
+
+#define OODLE_MEMORY_HINT_MIN_BYTES	(2*1024*1024)	IDOC
+/* Oodle only calls $t_fp_OodleCore_Plugin_MemoryHint for allocations at least this big
+*/
+
+IDOC OODEFFUNC typedef void (OODLE_CALLBACK t_fp_OodleCore_Plugin_MemoryHint)( void * ptr, OO_SINTa bytes, OO_U32 flags );
+/* Function pointer type for OodleCore_Plugins_SetMemoryHint
+
+	$:ptr		block just returned by the installed $t_fp_OodleCore_Plugin_MallocAligned , or caller memory for OODLE_MEMORY_HINT_WILL_READ
+	$:bytes		size of the block
+	$:flags		combination of OODLE_MEMORY_HINT_ flags
+
+	Called right after a big encoder table is allocated, before Oodle first writes to it.
+	The memory is still owned by your allocator and will be freed with $t_fp_OodleCore_Plugin_Free ;
+	the hint may change how it is backed (madvise, mbind) but must not move or free it.
+
+	OODLE_MEMORY_HINT_WILL_READ is different : _ptr_ is not page aligned and points into memory Oodle
+	doesn't own.  It's called from the decoding thread ahead of the data being read, and must not block
+	on the read.
+
+	Because the hint runs before the first write, first-touch page placement already puts
+	OODLE_MEMORY_HINT_THREAD_LOCAL blocks on the node of the worker running the job.
+*/
+
+IDOC OOFUNC1 t_fp_OodleCore_Plugin_MemoryHint * OOFUNC2 OodleCore_Plugins_SetMemoryHint(t_fp_OodleCore_Plugin_MemoryHint * fp_MemoryHint);
+/* Install the callback Oodle Core uses to advise the OS about big encoder tables
+
+	$:fp_MemoryHint	function pointer to your hint function; may be NULL to disable hints
+	$:return		returns the previous function pointer
+
+	The default implementation on Linux calls madvise(MADV_HUGEPAGE) on the 2 MB aligned interior
+	of OODLE_MEMORY_HINT_LARGE_RANDOM_ACCESS blocks, so transparent huge pages are used when the
+	system has them in "madvise" mode, and madvise(MADV_WILLNEED) on OODLE_MEMORY_HINT_WILL_READ ranges,
+	which starts async read-ahead for file mappings.  On other platforms the default does nothing.
+
+	Install your own to use explicit huge pages (hugetlbfs) together with a matching allocator,
+	or to bind OODLE_MEMORY_HINT_THREAD_LOCAL blocks to the current NUMA node.  On Windows,
+	PrefetchVirtualMemory does the job of MADV_WILLNEED.
+
+	WARNING : this function is NOT thread safe!  It should be done only once and done in a place where the caller can guarantee thread safety.
+*/
+
 IDOC OODEFFUNC typedef OO_U64 (OODLE_CALLBACK t_fp_OodleCore_Plugin_RunJob)( t_fp_Oodle_Job * fp_job, void * job_data , OO_U64 * dependencies, int num_dependencies, void * user_ptr );
 /* Function pointer type for OodleCore_Plugins_SetJobSystem
 
@@ -216,6 +273,7 @@ IDOC OOFUNC1 t_fp_OodleCore_Plugin_DisplayAssertion * OOFUNC2 OodleCore_Plugins_
 
 OOFUNC1 void * OOFUNC2 OodleCore_Plugin_MallocAligned_Default(OO_SINTa size,OO_S32 alignment);
 OOFUNC1 void OOFUNC2 OodleCore_Plugin_Free_Default(void * ptr);
+OOFUNC1 void OOFUNC2 OodleCore_Plugin_MemoryHint_Default(void * ptr,OO_SINTa bytes,OO_U32 flags);
 OOFUNC1 void OOFUNC2 OodleCore_Plugin_Printf_Default(int verboseLevel,const char * file,int line,const char * fmt,...);
 OOFUNC1 void OOFUNC2 OodleCore_Plugin_Printf_Verbose(int verboseLevel,const char * file,int line,const char * fmt,...);
 OOFUNC1 OO_BOOL OOFUNC2 OodleCore_Plugin_DisplayAssertion_Default(const char * file,const int line,const char * function,const char * message);
@@ -232,6 +290,7 @@ PUBEND
 
 extern t_fp_OodleCore_Plugin_MallocAligned * g_fp_OodleCore_Plugin_MallocAligned;
 extern t_fp_OodleCore_Plugin_Free * g_fp_OodleCore_Plugin_Free;
+extern t_fp_OodleCore_Plugin_MemoryHint * g_fp_OodleCore_Plugin_MemoryHint;
 extern t_fp_OodleCore_Plugin_DisplayAssertion * g_fp_OodleCore_Plugin_DisplayAssertion;
 extern t_fp_OodleCore_Plugin_Printf *	g_fp_OodleCore_Plugin_Printf;
 extern t_fp_OodleCore_Plugin_RunJob *	g_fp_OodleCore_Plugin_RunJob;
@@ -305,7 +305,9 @@ IDOC typedef OOSTRUCT OodleLZ_CompressOptions
 	OO_S32				farMatchMinLen;	// far matches must be at least this len
 	OO_S32				farMatchOffsetLog2; // if not zero, the log2 of an offset that must meet farMatchMinLen
 
-	OO_U32				reserved[4];   // reserved space for adding more options; zero these!
+	OO_BOOL				suffixArrayMatchFinder;	// (Kraken/Leviathan Optimal2+) find matches with a suffix array instead of the suffix trie
+
+	OO_U32				reserved[3];   // reserved space for adding more options; zero these!
 } OodleLZ_CompressOptions;
 /* Options for the compressor
 
@@ -379,6 +381,12 @@ IDOC typedef OOSTRUCT OodleLZ_CompressOptions
 	job system plugins set with $OodleCore_Plugins_SetJobSystem.  Not all compressors or compression level support
 	jobs, but the slower ones generally do.  The default value of jobify is to use a thread system if one is installed.
 
+	_suffixArrayMatchFinder_ : Kraken and Leviathan at Optimal2 and up normally find matches with a suffix trie.  With
+	this set they suffix sort each window up front instead, splitting the sort across jobs when _jobify_ allows.  The
+	longest match at each position is exact, but the shorter candidate matches differ from the trie's, so the output
+	is not the same : within about 0.1% in size either way.  Peak memory is about 24 bytes per byte of window.
+	Off by default.
+
 	_farMatchMinLen_ and _farMatchOffsetLog2_ can be used to tune the encoded stream for a known cache size on the
 	decoding hardware.  If set, then offsets with log2 greater or each to _farMatchOffsetLog2_ must have a minimum
 	length of _farMatchMinLen_.  For example to target a machine with a 2 MB cache, set _farMatchOffsetLog2_ to 21,
@@ -475,6 +483,14 @@ IDOC typedef OOSTRUCT OodleLZ_DecodeSome_Out
 /* Output value of $OodleLZDecoder_DecodeSome
 */
 
+IDOC typedef OOSTRUCT OodleLZ_DecodeSegment
+{
+	void *		ptr;	// where this piece of the output goes
+	OO_SINTa	len;	// length of the piece ; a multiple of $OODLELZ_BLOCK_LEN except for the last one
+} OodleLZ_DecodeSegment;
+/* One piece of non-contiguous output for $OodleLZ_DecompressSegments
+*/
+
 //---------------------------------------------
 PUBTYPEEND
 
@@ -505,7 +521,7 @@ IDOC OOFUNC1 OO_SINTa OOFUNC2 OodleLZ_Compress(OodleLZ_Compressor compressor,
 	$:level			OodleLZ_CompressionLevel controls how much CPU effort is put into maximizing compression
 	$:pOptions			(optional) options; if NULL, $OodleLZ_CompressOptions_GetDefault is used
 	$:dictionaryBase	(optional) if not NULL, provides preceding data to prime the dictionary; must be contiguous with rawBuf, the data between the pointers _dictionaryBase_ and _rawBuf_ is used as the preconditioning data.  The exact same precondition must be passed to encoder and decoder.
-	$:lrm				(optional) long range matcher
+	$:lrm				(optional) long range matcher made with $OodleLZ_CreateLRM on _dictionaryBase_
 	$:scratchMem		(optional) pointer to scratch memory
 	$:scratchSize		(optional) size of scratch memory (see $OodleLZ_GetCompressScratchMemBound)
 	$:return	size of compressed data written, or $OODLELZ_FAILED for failure
@@ -535,6 +551,169 @@ IDOC OOFUNC1 OO_SINTa OOFUNC2 OodleLZ_Compress(OodleLZ_Compressor compressor,
 
 */
 
+IDOC OOFUNC1 void * OOFUNC2 OodleLZ_CreateLRM(const void * buf,OO_SINTa bufLen,
+	const OodleLZ_CompressOptions * pOptions OODEFAULT(NULL));
+/* Index a buffer for long range matching, to reuse across several $OodleLZ_Compress calls
+
+	$:buf		start of the data to index ; pass the same pointer as _dictionaryBase_ to $OodleLZ_Compress
+	$:bufLen	number of bytes to index
+	$:pOptions	(optional) options; must have the same _maxLocalDictionarySize_ as the compress calls
+	$:return	an LRM to pass as the _lrm_ argument of $OodleLZ_Compress, or NULL if none could be made
+
+	Use this when you compress new data against a large preceding dictionary more than once, eg.
+	successive versions of a mostly-unchanged blob, or an append-only log.  Put the old data and the
+	new data in one buffer, old first, and compress the new part with _dictionaryBase_ at the start.
+
+	Without an LRM, every compress with a dictionary bigger than _maxLocalDictionarySize_ has to hash
+	the whole dictionary again.  With one, only the local window before _rawBuf_ is indexed by the
+	match finder, and the rest of the dictionary is found through the LRM.
+
+	The LRM is only used at levels >= $OodleLZ_CompressionLevel_Optimal1 and only when the data plus dictionary
+	is bigger than _maxLocalDictionarySize_.  It indexes whole multiples of _maxLocalDictionarySize_/2 ;
+	a tail shorter than that is not indexed.  So once the new data is in place after the old, call
+	$OodleLZ_ExtendLRM over it before compressing ; that hashes only the new bytes, picks up the old tail,
+	and leaves the LRM ready for the next version to be appended.
+
+	The LRM points into _buf_ ; the data must stay in place and unchanged while the LRM is alive.
+
+	If a job system is installed and _pOptions_ allows jobify, the index is built with jobs.
+
+	Free with $OodleLZ_FreeLRM.
+
+	Returns NULL on platforms without the Optimal level match finders.
+*/
+
+IDOC OOFUNC1 OO_BOOL OOFUNC2 OodleLZ_ExtendLRM(void * lrm,const void * buf,OO_SINTa bufLen);
+/* Grow an LRM made with $OodleLZ_CreateLRM to cover data appended to the same buffer
+
+	$:lrm		an LRM from $OodleLZ_CreateLRM
+	$:buf		the same pointer passed to $OodleLZ_CreateLRM
+	$:bufLen	new length of the data, >= the old length
+	$:return	false if _buf_ is not the buffer the LRM was made on
+
+	Only the appended bytes are hashed.  The result is the same as calling $OodleLZ_CreateLRM on
+	the longer buffer.
+
+	If $OodleLZ_Compress is given an LRM that doesn't reach the local window before _rawBuf_,
+	the bytes in between are not visible to the encoder, which costs compression but is not an error.
+*/
+
+IDOC OOFUNC1 void OOFUNC2 OodleLZ_FreeLRM(void * lrm);
+/* Free an LRM made with $OodleLZ_CreateLRM
+
+	$:lrm		an LRM from $OodleLZ_CreateLRM, or NULL
+*/
+
+#define OODLELZ_PATCH_MAX_REFERENCE	(1<<29)	IDOC
+/* Only the last this-many bytes of a patch reference are visible to $OodleLZ_CompressPatch
+
+	This is the farthest back a match can reach in an OodleLZ stream.  For bigger references,
+	split the data into pieces and patch each against the matching part of the reference.
+*/
+
+struct OodleLZ_PatchReference;
+IDOC typedef struct OodleLZ_PatchReference OodleLZ_PatchReference;
+/* Opaque reference data for $OodleLZ_CompressPatch, made by $OodleLZ_PatchReference_Create
+*/
+
+IDOC OOFUNC1 OodleLZ_PatchReference * OOFUNC2 OodleLZ_PatchReference_Create(const void * refBuf,OO_SINTa refLen,
+	OO_SINTa maxRawLen,const OodleLZ_CompressOptions * pOptions OODEFAULT(NULL));
+/* Index a reference buffer once, to patch-compress any number of buffers against it
+
+	$:refBuf	the old data ; it is copied, and need not stay alive
+	$:refLen	length of _refBuf_
+	$:maxRawLen	the largest _rawLen_ that will be passed to $OodleLZ_CompressPatch
+	$:pOptions	(optional) options used for every $OodleLZ_CompressPatch with this reference
+	$:return	reference to pass to $OodleLZ_CompressPatch ; free with $OodleLZ_PatchReference_Free
+
+	The reference is copied into a private buffer with room for _maxRawLen_ after it, so that
+	_refBuf_ does not have to be contiguous with the data you compress.  A long range matcher
+	is built over it once (see $OodleLZ_CreateLRM) and reused by every $OodleLZ_CompressPatch.
+
+	If _refLen_ is more than $OODLELZ_PATCH_MAX_REFERENCE , only its tail is used.
+
+	An OodleLZ_PatchReference may only be used by one $OodleLZ_CompressPatch at a time.
+*/
+
+IDOC OOFUNC1 void OOFUNC2 OodleLZ_PatchReference_Free(OodleLZ_PatchReference * ref);
+/* Free a reference from $OodleLZ_PatchReference_Create
+*/
+
+IDOC OOFUNC1 OO_SINTa OOFUNC2 OodleLZ_CompressPatch(OodleLZ_Compressor compressor,
+	const void * rawBuf,OO_SINTa rawLen,void * compBuf,
+	OodleLZ_CompressionLevel level,
+	OodleLZ_PatchReference * ref);
+/* Compress new data with matches into a separate reference buffer
+
+	$:compressor	which OodleLZ variant to use in compression
+	$:rawBuf		new data to compress
+	$:rawLen		length of _rawBuf_ ; no more than the _maxRawLen_ given to $OodleLZ_PatchReference_Create
+	$:compBuf		output ; should be at least $OodleLZ_GetCompressedBufferSizeNeeded
+	$:level			compression level ; the reference is only fully visible at $OodleLZ_CompressionLevel_Optimal1 and up
+	$:ref			reference made with $OodleLZ_PatchReference_Create
+	$:return		size of compressed data written, or $OODLELZ_FAILED
+
+	The output is an ordinary OodleLZ stream that uses the reference as its dictionary.
+	Decode it with $OodleLZ_DecompressPatch and the same reference bytes.
+
+	Only the appended data is hashed on each call ; the reference index is reused.
+*/
+
+IDOC OOFUNC1 OO_SINTa OOFUNC2 OodleLZ_DecompressPatch(const void * compBuf,OO_SINTa compBufSize,
+	void * rawBuf,OO_SINTa rawLen,
+	const void * refBuf,OO_SINTa refLen,
+	OodleLZ_FuzzSafe fuzzSafe OODEFAULT(OodleLZ_FuzzSafe_Yes),
+	OodleLZ_CheckCRC checkCRC OODEFAULT(OodleLZ_CheckCRC_No));
+/* Decompress data made by $OodleLZ_CompressPatch
+
+	$:compBuf		compressed data
+	$:compBufSize	size of _compBuf_
+	$:rawBuf		output ; _rawLen_ bytes
+	$:rawLen		exact decompressed length
+	$:refBuf		the same reference bytes given to $OodleLZ_PatchReference_Create
+	$:refLen		length of _refBuf_
+	$:fuzzSafe		see $OodleLZ_Decompress
+	$:checkCRC		see $OodleLZ_Decompress
+	$:return		_rawLen_ on success, or $OODLELZ_FAILED
+
+	The decoder puts the (tail of the) reference right before the output in a temporary buffer
+	and runs a normal $OodleLZ_Decompress with that as _decBufBase_, so decode speed is the same
+	as any other OodleLZ stream, plus one copy of the reference and one of the output.
+
+	For big references use $OodleLZ_DecompressPatchInPlace , which needs neither the temporary
+	buffer nor the copies.
+*/
+
+IDOC OOFUNC1 OO_SINTa OOFUNC2 OodleLZ_GetPatchDecodePad(OO_SINTa refLen);
+/* Scratch space $OodleLZ_DecompressPatchInPlace needs in front of the reference
+
+	$:refLen	length of the reference
+	$:return	bytes to reserve before the reference ; less than $OODLELZ_BLOCK_LEN
+*/
+
+IDOC OOFUNC1 OO_SINTa OOFUNC2 OodleLZ_DecompressPatchInPlace(const void * compBuf,OO_SINTa compBufSize,
+	void * patchBuf,OO_SINTa refLen,OO_SINTa rawLen,
+	OodleLZ_FuzzSafe fuzzSafe OODEFAULT(OodleLZ_FuzzSafe_Yes),
+	OodleLZ_CheckCRC checkCRC OODEFAULT(OodleLZ_CheckCRC_No));
+/* Decompress data made by $OodleLZ_CompressPatch right after the reference, in the caller's buffer
+
+	$:compBuf		compressed data
+	$:compBufSize	size of _compBuf_
+	$:patchBuf		[ pad | reference | raw ] : $OodleLZ_GetPatchDecodePad(_refLen_) bytes of scratch,
+					then the reference bytes, then room for _rawLen_ bytes of output
+	$:refLen		length of the reference in _patchBuf_
+	$:rawLen		exact decompressed length
+	$:fuzzSafe		see $OodleLZ_Decompress
+	$:checkCRC		see $OodleLZ_Decompress
+	$:return		_rawLen_ on success, or $OODLELZ_FAILED
+
+	The output goes to _patchBuf_ + pad + _refLen_ .  The pad is zeroed here ; it keeps the output a
+	multiple of $OODLELZ_BLOCK_LEN from the start of the dictionary, as the encoder laid it out.
+	Nothing is allocated or copied, so peak memory is just _patchBuf_.
+
+	$OodleLZ_DecompressPatch is this with a temporary buffer and copies in and out.
+*/
+
 // Decompress returns raw (decompressed) len received
 // Decompress returns 0 (OODLELZ_FAILED) if it detects corruption
 IDOC OOFUNC1 OO_SINTa OOFUNC2 OodleLZ_Decompress(const void * compBuf,OO_SINTa compBufSize,void * rawBuf,OO_SINTa rawLen,
@@ -621,6 +800,186 @@ IDOC OOFUNC1 OO_SINTa OOFUNC2 OodleLZ_Decompress(const void * compBuf,OO_SINTa c
 */
 
 
+IDOC OOFUNC1 OO_SINTa OOFUNC2 OodleLZ_DecompressSegments(const void * compBuf,OO_SINTa compBufSize,
+	const OodleLZ_DecodeSegment * segments,OO_S32 numSegments,
+	OO_S32 dictionarySize,
+	OodleLZ_FuzzSafe fuzzSafe OODEFAULT(OodleLZ_FuzzSafe_Yes),
+	OodleLZ_CheckCRC checkCRC OODEFAULT(OodleLZ_CheckCRC_No));
+/* Decompress into a list of non-contiguous output segments (scatter-gather)
+
+	$:compBuf		compressed data
+	$:compBufSize	size of _compBuf_
+	$:segments		the output pieces, in order ; they add up to the raw length of the stream
+	$:numSegments	number of _segments_
+	$:dictionarySize	the $(OodleLZ_CompressOptions:dictionarySize) the data was encoded with ; <= 0 if unlimited
+	$:fuzzSafe		see $OodleLZ_Decompress
+	$:checkCRC		see $OodleLZ_Decompress
+	$:return		total raw length decoded on success, or $OODLELZ_FAILED
+
+	Every segment except the last must be a multiple of $OODLELZ_BLOCK_LEN long.
+
+	Segments that start on an independent block (eg. with $(OodleLZ_CompressOptions:seekChunkReset)
+	and a _seekChunkLen_ that divides the segment boundaries) are decoded directly into place.
+
+	Otherwise only the first _dictionarySize_ bytes of a segment (rounded up to $OODLELZ_BLOCK_LEN)
+	can reference earlier segments.  Those are decoded into a scratch buffer behind a copy of the
+	preceding _dictionarySize_ bytes and copied into place ; the rest of the segment is decoded
+	directly into place.  This is cheap when _dictionarySize_ is small relative to the segment length.
+
+	With an unlimited _dictionarySize_ the whole stream is decoded to a scratch buffer and copied out.
+
+	_dictionarySize_ must be no smaller than what the encoder used, or the decode fails.
+*/
+
+IDOC OOFUNC1 OO_SINTa OOFUNC2 OodleLZ_DecompressThreadPhased(const void * compBuf,OO_SINTa compBufSize,
+	void * rawBuf,OO_SINTa rawLen,
+	OodleLZ_FuzzSafe fuzzSafe OODEFAULT(OodleLZ_FuzzSafe_Yes),
+	OodleLZ_CheckCRC checkCRC OODEFAULT(OodleLZ_CheckCRC_No),
+	OodleLZ_Jobify jobify OODEFAULT(OodleLZ_Jobify_Default),
+	void * jobifyUserPtr OODEFAULT(NULL));
+/* Decompress a whole buffer with ThreadPhased decoding on the installed job system
+
+	$:compBuf		compressed data
+	$:compBufSize	size of _compBuf_
+	$:rawBuf		output buffer ; must not overlap _compBuf_
+	$:rawLen		raw length of the stream
+	$:fuzzSafe		see $OodleLZ_Decompress
+	$:checkCRC		see $OodleLZ_Decompress
+	$:jobify		_OodleLZ_Jobify_Normal_ keeps 4 blocks of Phase1 in flight, _Aggressive_ 8 ; _Disable_ decodes serially
+	$:jobifyUserPtr	passed through to the RunJob and WaitJob callbacks
+	$:return		_rawLen_ on success, or $OODLELZ_FAILED
+
+	Runs Phase1 (the entropy decode of the chunk arrays) of several blocks at once on jobs, while the
+	calling thread runs Phase2 (the LZ parse) of each block in order as its Phase1 finishes.
+	See $OodleLZ_About_ThreadPhasedDecode.
+
+	This does not need seek resets, so it helps latency on buffers of a few MB that have none.
+
+	Falls back to a plain $OodleLZ_Decompress if no job system is installed, if the stream is a single
+	block, or if the compressor can't $OodleLZ_Compressor_CanDecodeThreadPhased.
+
+	Uses _jobify_ * $OodleLZ_ThreadPhased_BlockDecoderMemorySizeNeeded bytes of memory.
+	WaitJob is only called from the calling thread.
+*/
+
+IDOC OOFUNC1 OO_SINTa OOFUNC2 OodleLZ_DecompressSeekChunks(const void * compBuf,OO_SINTa compBufSize,
+	void * rawBuf,OO_SINTa rawLen,
+	OodleLZ_FuzzSafe fuzzSafe OODEFAULT(OodleLZ_FuzzSafe_Yes),
+	OodleLZ_CheckCRC checkCRC OODEFAULT(OodleLZ_CheckCRC_No),
+	OodleLZ_Jobify jobify OODEFAULT(OodleLZ_Jobify_Default),
+	void * jobifyUserPtr OODEFAULT(NULL));
+/* Decompress a whole buffer, decoding its independent seek chunks in parallel on the installed job system
+
+	$:compBuf		compressed data
+	$:compBufSize	size of _compBuf_
+	$:rawBuf		output buffer ; must not overlap _compBuf_
+	$:rawLen		raw length of the stream
+	$:fuzzSafe		see $OodleLZ_Decompress
+	$:checkCRC		see $OodleLZ_Decompress
+	$:jobify		_OodleLZ_Jobify_Normal_ runs up to 8 seek chunks at once, _Aggressive_ 32 ; _Disable_ decodes serially
+	$:jobifyUserPtr	passed through to the RunJob and WaitJob callbacks
+	$:return		_rawLen_ on success, or $OODLELZ_FAILED
+
+	Works for every compressor, including the legacy ones like $OodleLZ_Compressor_LZB16.  The seek chunks
+	are found by stepping the block headers (see $OodleLZ_GetCompressedStepForRawStep), so no $OodleLZ_SeekTable
+	is needed.  A seek chunk starts at each block that was encoded with a reset (see
+	$(OodleLZ_CompressOptions:seekChunkReset)).
+
+	Falls back to a plain $OodleLZ_Decompress if no job system is installed or the data has no seek resets.
+	For NewLZ data without seek resets, see $OodleLZ_DecompressThreadPhased.
+
+	Blocks between seek resets can't be scheduled any finer.  The decoder only starts a block without history
+	at a reset, and nearly every other block reads the end of the block before it, so their dependencies are
+	a single chain even with a small _dictionarySize_.
+
+	WaitJob is only called from the calling thread.
+*/
+
+IDOC OOFUNC1 OO_SINTa OOFUNC2 OodleLZ_DecompressReadAhead(const void * compBuf,OO_SINTa compBufSize,
+	void * rawBuf,OO_SINTa rawLen,
+	OO_SINTa readAheadBytes OODEFAULT(0),
+	OodleLZ_FuzzSafe fuzzSafe OODEFAULT(OodleLZ_FuzzSafe_Yes),
+	OodleLZ_CheckCRC checkCRC OODEFAULT(OodleLZ_CheckCRC_No),
+	OodleLZ_Jobify jobify OODEFAULT(OodleLZ_Jobify_Default),
+	void * jobifyUserPtr OODEFAULT(NULL));
+/* $OodleLZ_DecompressSeekChunks for compressed data in a memory-mapped file
+
+	$:compBuf			compressed data ; typically a slice of a file mapping
+	$:compBufSize		size of _compBuf_
+	$:rawBuf			output buffer ; must not overlap _compBuf_
+	$:rawLen			raw length of the stream
+	$:readAheadBytes	how far past the read position to keep advised ; 0 for the default (8 MB)
+	$:fuzzSafe			see $OodleLZ_Decompress
+	$:checkCRC			see $OodleLZ_Decompress
+	$:jobify			see $OodleLZ_DecompressSeekChunks
+	$:jobifyUserPtr		passed through to the RunJob and WaitJob callbacks
+	$:return			_rawLen_ on success, or $OODLELZ_FAILED
+
+	Decoding straight from a cold mapping takes a page fault every 4 KB of compressed data, and the decoder
+	waits on each one.  This decodes like $OodleLZ_DecompressSeekChunks , and keeps the next _readAheadBytes_
+	of _compBuf_ advised with OODLE_MEMORY_HINT_WILL_READ so the reads are queued ahead of the decoder.
+	With the default memory hint plugin on Linux that's madvise(MADV_WILLNEED).
+
+	In the serial decode the window follows the block being decoded.  When seek chunks run on jobs, it
+	follows the calling thread as it finds the chunks, which is ahead of every running chunk.
+
+	Only compBuf is advised ; fault-in of _rawBuf_ is up to you.  Advice on memory that's already resident
+	costs a syscall per half window and does nothing.
+*/
+
+IDOC OOFUNC1 OO_SINTa OOFUNC2 OodleLZ_CompressHeaderlessQuanta(OodleLZ_Compressor compressor,
+	const void * rawBuf,const OO_S32 * quantumRawLens,const OO_BOOL * quantumIsReset,OO_S32 numQuanta,
+	void * compBuf,OO_SINTa compBufSize,OO_S32 * quantumCompLens,
+	OodleLZ_CompressionLevel level,
+	const OodleLZ_CompressOptions * pOptions OODEFAULT(NULL));
+/* Compress an array of quanta with no OodleLZ block or quantum headers
+
+	$:compressor	Kraken, Mermaid, Selkie or Leviathan
+	$:rawBuf		the quanta, back to back
+	$:quantumRawLens	raw length of each quantum, in [1,$OODLELZ_BLOCK_LEN]
+	$:quantumIsReset	(optional) true for each quantum that doesn't reference earlier ones ; NULL if every quantum is a reset
+	$:numQuanta		number of quanta
+	$:compBuf		receives the compressed quanta, back to back
+	$:compBufSize	size of _compBuf_ ; the sum of _quantumRawLens_ is always enough
+	$:quantumCompLens	filled with the compressed length of each quantum
+	$:level			see $OodleLZ_Compress
+	$:pOptions		(optional) see $OodleLZ_Compress ; _seekChunkReset_ and _sendQuantumCRCs_ are ignored
+	$:return		total compressed length, or $OODLELZ_FAILED
+
+	For containers that store their own sizes and don't want the per-block OodleLZ headers.  Each headerless
+	quantum is the payload of one OodleLZ block (see $OODLELZ_BLOCK_LEN).  A quantum never expands ; if
+	_quantumCompLens_ equals the raw length it is stored uncompressed.  You must keep _quantumRawLens_ ,
+	_quantumCompLens_ and _quantumIsReset_ to decode with $OodleLZ_DecompressHeaderlessQuanta.
+
+	The first quantum is always a reset.  A quantum followed by a non-reset quantum must be $OODLELZ_BLOCK_LEN long.
+
+	Runs of quanta between resets are compressed in parallel if _pOptions_ jobify allows and a job system is installed.
+*/
+
+IDOC OOFUNC1 OO_SINTa OOFUNC2 OodleLZ_DecompressHeaderlessQuanta(OodleLZ_Compressor compressor,
+	const void * compBuf,OO_SINTa compBufSize,const OO_S32 * quantumCompLens,
+	void * rawBuf,const OO_S32 * quantumRawLens,const OO_BOOL * quantumIsReset,OO_S32 numQuanta,
+	OodleLZ_Jobify jobify OODEFAULT(OodleLZ_Jobify_Default),
+	void * jobifyUserPtr OODEFAULT(NULL));
+/* Decompress an array of quanta made by $OodleLZ_CompressHeaderlessQuanta
+
+	$:compressor	the compressor passed to $OodleLZ_CompressHeaderlessQuanta
+	$:compBuf		the compressed quanta, back to back
+	$:compBufSize	size of _compBuf_
+	$:quantumCompLens	compressed length of each quantum
+	$:rawBuf		receives the quanta, back to back ; must not overlap _compBuf_
+	$:quantumRawLens	raw length of each quantum
+	$:quantumIsReset	(optional) as passed to $OodleLZ_CompressHeaderlessQuanta
+	$:numQuanta		number of quanta
+	$:jobify		_OodleLZ_Jobify_Normal_ runs up to 8 runs of quanta between resets at once, _Aggressive_ 32 ; _Disable_ decodes serially
+	$:jobifyUserPtr	passed through to the RunJob and WaitJob callbacks
+	$:return		total raw length, or $OODLELZ_FAILED
+
+	The decode is fuzz safe.  Decoder scratch memory is allocated once per call (once per job slot when jobified).
+
+	WaitJob is only called from the calling thread.
+*/
+
 //-------------------------------------------
 // Incremental Decoder functions :
 
@@ -928,6 +1287,39 @@ IDOC OOFUNC1 OO_BOOL OOFUNC2 OodleLZ_CheckSeekTableCRCs(const void * rawBuf,OO_S
 	Checking the CRC of compressed data is faster, but does not verify that the decompress succeeded.
 */
 
+IDOC OOFUNC1 OO_S32 OOFUNC2 OodleLZ_Verify(const void * compBuf,OO_SINTa compBufSize,
+	const OodleLZ_SeekTable * seekTable,
+	OO_S32 dictionarySize,
+	OO_U8 * chunkFailed OODEFAULT(NULL),
+	OodleLZ_FuzzSafe fuzzSafe OODEFAULT(OodleLZ_FuzzSafe_Yes),
+	OodleLZ_CheckCRC checkCRC OODEFAULT(OodleLZ_CheckCRC_No),
+	OodleLZ_Jobify jobify OODEFAULT(OodleLZ_Jobify_Default),
+	void * jobifyUserPtr OODEFAULT(NULL));
+/* Decompress and check each seek chunk without keeping the whole raw buffer
+
+	$:compBuf		compressed data
+	$:compBufSize	size of _compBuf_ ; at least _totalCompLen_ of the seek table
+	$:seekTable		result of $OodleLZ_CreateSeekTable for _compBuf_
+	$:dictionarySize	the $(OodleLZ_CompressOptions:dictionarySize) the data was encoded with ; <= 0 if unlimited
+	$:chunkFailed	(optional) _numSeekChunks_ bytes ; set to 1 for each chunk that failed, 0 for the rest
+	$:fuzzSafe		see $OodleLZ_Decompress
+	$:checkCRC		see $OodleLZ_Decompress
+	$:jobify		_OodleLZ_Jobify_Normal_ checks up to 8 independent seek chunks at once, _Aggressive_ 32 ; _Disable_ checks serially
+	$:jobifyUserPtr	passed through to the RunJob and WaitJob callbacks
+	$:return		number of seek chunks that failed (0 if all good), or -1 for bad arguments
+
+	A seek chunk fails if it doesn't decode, or if the seek table has _rawCRCs_ and the CRC of the decoded bytes
+	doesn't match (see $OodleLZ_CheckSeekTableCRCs).
+
+	The raw data is decoded through a window and thrown away.  If _seekChunksIndependent_ , each chunk
+	is decoded on its own into a buffer of _seekChunkLen_ , and the chunks are run on the job system if one is installed.
+	Otherwise chunks are decoded in order and the last _dictionarySize_ bytes are kept as history ; with an
+	unlimited _dictionarySize_ that is the whole raw buffer.  A _dictionarySize_ that is too small shows up as
+	failed chunks.
+
+	WaitJob is only called from the calling thread.
+*/
+
 IDOC OOFUNC1 OO_S32 OOFUNC2 OodleLZ_FindSeekEntry( OO_S64 rawPos, const OodleLZ_SeekTable * seekTable);
 /* Find the seek entry that contains a raw position
 
@@ -1264,6 +1656,37 @@ IDOC OOFUNC1 OO_SINTa OOFUNC2 OodleLZ_GetInPlaceDecodeBufferSize(OodleLZ_Compres
 	See $OodleLZ_Decompress for more.
 */
 
+IDOC OOFUNC1 OO_SINTa OOFUNC2 OodleLZ_DecompressInPlace(void * buf,OO_SINTa bufSize,
+	OO_SINTa compOffset,OO_SINTa compLen,OO_SINTa rawLen,
+	OodleLZ_FuzzSafe fuzzSafe OODEFAULT(OodleLZ_FuzzSafe_Yes),
+	OodleLZ_CheckCRC checkCRC OODEFAULT(OodleLZ_CheckCRC_No));
+/* Decompress "in place" ; the compressed data is in _buf_ and the raw data replaces it
+
+	$:buf			buffer holding the compressed data ; receives the raw data at its start
+	$:bufSize		size of _buf_ ; must be at least $OodleLZ_GetInPlaceDecodeBufferSize
+	$:compOffset	where the compressed data currently is in _buf_
+	$:compLen		compressed data length
+	$:rawLen		decompressed data length
+	$:fuzzSafe		see $OodleLZ_Decompress
+	$:checkCRC		see $OodleLZ_Decompress
+	$:return		_rawLen_ on success, or $OODLELZ_FAILED
+
+	If the compressed data is not already at the end of _buf_ , it is moved there first ; eg. read the compressed
+	data to the start of _buf_ and pass _compOffset_ = 0.
+
+	To skip the move, read the compressed data straight into the end :
+
+	{
+		OO_SINTa bufSize = OodleLZ_GetInPlaceDecodeBufferSize(OodleLZ_Compressor_Invalid,compLen,rawLen);
+		void * buf = malloc(bufSize);
+		pread(fd,(char *)buf + bufSize - compLen,compLen,fileOffset);
+		OodleLZ_DecompressInPlace(buf,bufSize,bufSize - compLen,compLen,rawLen);
+	}
+
+	The size check uses the actual compressor of the data, so _bufSize_ computed for it (rather than
+	$OodleLZ_Compressor_Invalid) is fine.
+*/
+
 // GetCompressedStepForRawStep is at OODLELZ_QUANTUM_LEN granularity
 //	returns how many packed bytes to step to get the desired raw count step
 IDOC OOFUNC1 OO_SINTa OOFUNC2 OodleLZ_GetCompressedStepForRawStep(
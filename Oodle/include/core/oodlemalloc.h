@@ -59,6 +59,33 @@ static RADINLINE void OodleFreeSized(void * ptr, SINTa bytes)
 	(*g_fp_OodlePlugin_Free)(ptr);
 }
 
+// OodleMemoryHint : call right after allocating a big table, before the first write
+//	so the OS can back it with large pages / place it on the local node
+//	small blocks are skipped ; no-op in builds whose plugins have no hint
+static RADINLINE void OodleMemoryHint(void * ptr, SINTa bytes, U32 flags)
+{
+	#ifdef g_fp_OodlePlugin_MemoryHint
+	if ( bytes >= OODLE_MEMORY_HINT_MIN_BYTES && g_fp_OodlePlugin_MemoryHint != NULL )
+		(*g_fp_OodlePlugin_MemoryHint)(ptr,bytes,flags);
+	#else
+	RR_UNUSED_VARIABLE(ptr);
+	RR_UNUSED_VARIABLE(bytes);
+	RR_UNUSED_VARIABLE(flags);
+	#endif
+}
+
+// OodleMemoryHintWillRead : compressed input about to be decoded ; any size
+static RADINLINE void OodleMemoryHintWillRead(const void * ptr, SINTa bytes)
+{
+	#ifdef g_fp_OodlePlugin_MemoryHint
+	if ( bytes > 0 && g_fp_OodlePlugin_MemoryHint != NULL )
+		(*g_fp_OodlePlugin_MemoryHint)(const_cast<void *>(ptr),bytes,OODLE_MEMORY_HINT_WILL_READ);
+	#else
+	RR_UNUSED_VARIABLE(ptr);
+	RR_UNUSED_VARIABLE(bytes);
+	#endif
+}
+
 OODLE_NS_END
 
 //===========================================
@@ -0,0 +1,49 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+// This source file is licensed solely to users who have
+// accepted a valid Unreal Engine license agreement 
+// (see e.g., https://www.unrealengine.com/eula), and use
+// of this source file is governed by such agreement.
+
+#pragma once
+
+#include "oodlebase.h"
+#include "oodlelzpub.h" // OodleLZ_Jobify
+
+enum { SuffixArray_MaxSize = (1UL<<30) }; // S32 indices ; bigger buffers fall back to SuffixTrie_CreateMatchFinder
+
+/*
+
+SuffixArray match finder : drop-in for SuffixTrie_CreateMatchFinder
+Kraken & Leviathan Optimal2+ use it when OodleLZ_CompressOptions::suffixArrayMatchFinder is set
+
+same output format as SuffixTrie ; at each pos, a list of [length,offset] pairs
+longest first, each shorter match at a strictly lower offset, terminated by length 0
+
+the whole buffer is suffix sorted up front (split across jobs when jobify allows it)
+then ProcessChunk walks the suffix tree the same way SuffixTrie does
+
+unlike SuffixTrie, the *longest* match and its offset are exact (lowest offset of the longest length)
+shorter matches are still limited by a parent step count
+
+memory use at peak is around 24 bytes per input byte
+
+*/
+
+struct LRMSet;
+class IncrementalMatchFinder;
+
+#if OODLE_PLATFORM_HAS_ADVANCED_MATCHERS
+
+OODLE_NS_START
+
+IncrementalMatchFinder * SuffixArray_CreateMatchFinder(const U8 * ubuf,SINTa size,
+		SINTa startRecordingPos RADDEFAULT(0),
+		LRMSet * lrms RADDEFAULT(NULL),
+		OodleLZ_Jobify jobify RADDEFAULT(OodleLZ_Jobify_Default),
+		void * jobifyUserPtr RADDEFAULT(NULL));
+
+// true if SuffixArray_CreateMatchFinder on a buffer of this size runs (and waits on) jobs
+bool SuffixArray_CreateRunsJobs(SINTa size,OodleLZ_Jobify jobify);
+
+OODLE_NS_END
+#endif // OODLE_PLATFORM_HAS_ADVANCED_MATCHERS
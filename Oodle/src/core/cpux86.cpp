@@ -14,6 +14,11 @@
 	#if _MSC_VER >= 1500 // VC++2008 or later
 	#define HAVE_CPUIDEX
 	#endif
+
+	#if _MSC_VER >= 1600 // VC++2010 SP1 or later
+	#define HAVE_XGETBV
+	#define rr_xgetbv(index)	_xgetbv(index)
+	#endif
 #elif 0 // defined(__RADANDROID__)
 #include <cpuid.h>
 
@@ -57,6 +62,14 @@
 
 	#define HAVE_CPUIDEX
 	#define __cpuid(out, leaf_id) __cpuidex(out, leaf_id, 0)
+
+	static inline unsigned long long rr_xgetbv(unsigned int index)
+	{
+		unsigned int eax, edx;
+		asm(".byte 0x0f, 0x01, 0xd0" : "=a" (eax), "=d" (edx) : "c" (index)); // xgetbv
+		return ((unsigned long long)edx << 32) | eax;
+	}
+	#define HAVE_XGETBV
 #endif // _MSC_VER or not
 
 
@@ -102,6 +115,18 @@ void rrCPUx86_detect()
 	if (cpuid_info[2] & (1u<<28))	features |= RRX86_CPU_AVX;
 	if (cpuid_info[2] & (1u<<29))	features |= RRX86_CPU_F16C;
 
+	// AVX-512 needs the OS to save opmask + ZMM state, not just the CPUID bits
+	bool os_avx512 = false;
+#ifdef HAVE_XGETBV
+	if (cpuid_info[2] & (1u<<27)) // OSXSAVE
+	{
+		// XCR0 : SSE, AVX, opmask, ZMM_Hi256, Hi16_ZMM
+		const U32 xcr0_avx512 = (1u<<1) | (1u<<2) | (1u<<5) | (1u<<6) | (1u<<7);
+		os_avx512 = ((U32)rr_xgetbv(0) & xcr0_avx512) == xcr0_avx512;
+	}
+#endif
+	RR_UNUSED_VARIABLE(os_avx512);
+
 	if (is_amd)
 	{
 		U32 family = (cpuid_info[0] >> 8) & 0xf;
@@ -130,6 +155,14 @@ void rrCPUx86_detect()
 			if (cpuid_info[1] & (1u<< 3))	features |= RRX86_CPU_BMI1;
 			if (cpuid_info[1] & (1u<< 8))	features |= RRX86_CPU_BMI2;
 			if (cpuid_info[1] & (1u<< 5))	features |= RRX86_CPU_AVX2;
+
+			// F (ebx 16), BW (ebx 30), VL (ebx 31), VBMI (ecx 1), VBMI2 (ecx 6)
+			const U32 avx512_ebx = (1u<<16) | (1u<<30) | (1u<<31);
+			const U32 avx512_ecx = (1u<<1) | (1u<<6);
+			if (os_avx512 && (features & RRX86_CPU_AVX2) &&
+				((U32)cpuid_info[1] & avx512_ebx) == avx512_ebx &&
+				((U32)cpuid_info[2] & avx512_ecx) == avx512_ecx)
+				features |= RRX86_CPU_AVX512;
 		}
 	}
 #endif
@@ -620,6 +620,22 @@ so lazy merge will get the heap order wrong in this case
 
 @@ -> I don't actually know if this lazy update heuristic is reasonable
 
+
+Heap layout :
+
+a single heap of all N^2 candidates spends most of its time popping dead ones
+(candidates whose partner was merged away) out of a huge, cache-cold heap
+
+instead each histo i has a "row" heap of its candidates {i,j} with j > i
+and the outer heap only holds the best candidate of each row (N entries)
+
+dead candidates are dropped from the front of their row as soon as they're exposed
+and a whole row is dropped when its histo is merged away,
+so the outer heap stays small and the rows stay hot
+
+candidates are totally ordered (gain_J, then lowest src1, then lowest src2)
+so the merge order doesn't depend on the heap layout
+
 *******/
 
 struct lazy_merge_candidate
@@ -638,7 +654,12 @@ typedef U32 (histo_cost_bits_func_type)(const Histo256 & histo,SINTa sumCounts);
 // normal operator less will give a heap that pops largest first :
 bool operator < (const lazy_merge_candidate &lhs, const lazy_merge_candidate &rhs)
 {
-	return lhs.gain_J < rhs.gain_J;
+	if ( lhs.gain_J != rhs.gain_J )
+		return lhs.gain_J < rhs.gain_J;
+	// ties pop the lowest indices first :
+	if ( lhs.src1 != rhs.src1 )
+		return lhs.src1 > rhs.src1;
+	return lhs.src2 > rhs.src2;
 }
 
 void make_lazy_merge_candidate(lazy_merge_candidate & out_merge_candidate,
@@ -688,9 +709,15 @@ void make_lazy_merge_candidate(lazy_merge_candidate & out_merge_candidate,
 
 histo_cost_bits_func_type * entropysets_order0_codelen_bits_cpudetect()
 {
-#if defined(DO_SSE4_ALWAYS)
+#if defined(DO_AVX2_ALWAYS) && defined(RR_LOG2TABLE_SIZE)
+	return entropysets_order0_codelen_bits_avx2;
+#elif defined(DO_SSE4_ALWAYS)
 	return entropysets_order0_codelen_bits_sse4;
 #elif defined(DO_SSE4_TEST)
+	#if defined(DO_BUILD_AVX2) && defined(RR_LOG2TABLE_SIZE)
+	if ( newlz_simd_has_avx2_bulk() )
+		return entropysets_order0_codelen_bits_avx2;
+	#endif
 	if ( newlz_simd_has_sse4() )
 		return entropysets_order0_codelen_bits_sse4;
 	else
@@ -729,96 +756,139 @@ void merge_entropysets(
 		cur.complen = (*histo_cost_bits_func)(cur.histo,cur.total);
 	}		
 			
-	vector_a<lazy_merge_candidate> merge_heap_vec;
-	int merge_heap_vec_init_size = histos_initial_count * (histos_initial_count-1) / 2;
-	rrScopeArenaAlloc merge_heap_vec_alloc( merge_heap_vec_init_size*sizeof(lazy_merge_candidate), arena );
-	merge_heap_vec.provide_arena(merge_heap_vec_alloc.m_ptr,merge_heap_vec_alloc.m_size);
-	merge_heap_vec.resize( merge_heap_vec_init_size );
-	lazy_merge_candidate * merge_heap = merge_heap_vec.data();
-	SINTa merge_heap_size = 0;
+	// row i holds candidates {i,j} for j > i, at row_base(i) in merge_cands
+	//	rows are filled in order so row i starts at sum of (N-1-k) for k < i
+	SINTa num_cands = (SINTa)histos_initial_count * (histos_initial_count-1) / 2;
+	SINTa merge_alloc_size = num_cands*sizeof(lazy_merge_candidate)
+		+ histos_initial_count*(sizeof(lazy_merge_candidate) + 2*sizeof(S32));
+	rrScopeArenaAlloc merge_alloc( merge_alloc_size, arena );
+	lazy_merge_candidate * merge_cands = (lazy_merge_candidate *) merge_alloc.m_ptr;
+	lazy_merge_candidate * row_heap = merge_cands + num_cands;
+	S32 * row_base = (S32 *)(row_heap + histos_initial_count);
+	S32 * row_size = row_base + histos_initial_count;
+	SINTa row_heap_size = 0;
 
+	{
+	SINTa cand_i = 0;
 	for(int i=0;i<histos_initial_count;i++)
 	{
+		lazy_merge_candidate * row = merge_cands + cand_i;
+		row_base[i] = S32_checkA(cand_i);
+		
 		for(int j=i+1;j<histos_initial_count;j++)
 		{
-			make_lazy_merge_candidate( merge_heap[merge_heap_size], histos[i],i, histos[j],j , merge_J_saved, histo_cost_bits_func);
-			merge_heap_size++;
+			make_lazy_merge_candidate( merge_cands[cand_i], histos[i],i, histos[j],j , merge_J_saved, histo_cost_bits_func);
+			cand_i++;
+		}
+		
+		row_size[i] = S32_checkA(rrPtrDiff(merge_cands + cand_i - row));
+		if ( row_size[i] > 0 )
+		{
+			make_heap(row,row+row_size[i]);
+			row_heap[row_heap_size++] = row[0];
 		}
 	}
+	RR_ASSERT( cand_i == num_cands );
+	}
 	
-	RR_ASSERT( merge_heap_size == merge_heap_vec.size32() );
-	
-	make_heap(merge_heap,merge_heap+merge_heap_size);
+	make_heap(row_heap,row_heap+row_heap_size);
 	
 	int num_histos_remaining = histos_initial_count;
 	
 	// while heap, do it :
-	while(merge_heap_size > 0 )
+	while( row_heap_size > 0 )
 	{
-		lazy_merge_candidate cur_merge = merge_heap[0];
-		popped_heap(merge_heap,merge_heap+merge_heap_size);
-		merge_heap_size--;
-				
+		lazy_merge_candidate cur_merge = row_heap[0];
+		popped_heap(row_heap,row_heap+row_heap_size);
+		row_heap_size--;
+		
 		int i = cur_merge.src1;
 		int j = cur_merge.src2;
 		
+		if ( histos[i].total == 0 )
+		{
+			// i was merged away, whole row is dead
+			continue;
+		}
+		
+		// take cur_merge off the front of its row :
+		lazy_merge_candidate * row = merge_cands + row_base[i];
+		RR_ASSERT( row_size[i] > 0 && row[0].src2 == j );
+		popped_heap(row,row+row_size[i]);
+		row_size[i]--;
+		
+		bool do_merge = false;
+		
 		// is it up to date ?
 		if ( histos[i].total != cur_merge.src1len ||
 			 histos[j].total != cur_merge.src2len )
 		{
-			// refresh it
-			
-			if ( histos[i].total == 0 ||
-				 histos[j].total == 0 )
+			// refresh it, unless it's gone
+			if ( histos[j].total != 0 )
 			{
-				// gone
-				continue;
+				make_lazy_merge_candidate( row[row_size[i]], histos[i],i, histos[j],j , merge_J_saved, histo_cost_bits_func);
+				row_size[i]++;
+				push_heap(row,row+row_size[i]);
 			}
-			else
+		}
+		else
+		{
+			// check it's up to date :
+			RR_ASSERT( histos[i].total == rrSumOfHistogram(histos[i].histo.counts,256) );
+			RR_ASSERT( histos[j].total == rrSumOfHistogram(histos[j].histo.counts,256) );
+			RR_ASSERT( histos[i].complen == (*histo_cost_bits_func)(histos[i].histo,histos[i].total) );
+			RR_ASSERT( histos[j].complen == (*histo_cost_bits_func)(histos[j].histo,histos[j].total) );
+			
+			// J is in bytes
+			
+			if ( cur_merge.gain_J < min_gain_J && num_histos_remaining <= max_histos_target )
 			{
-				make_lazy_merge_candidate( merge_heap[merge_heap_size], histos[i],i, histos[j],j , merge_J_saved, histo_cost_bits_func);
-				merge_heap_size++;
-				push_heap(merge_heap,merge_heap+merge_heap_size);
-				continue;
+				// we stop when we are under MAX_NUM_ARRAYS
+				//	AND we hit an unprofitable merge
+				break;
 			}
+			
+			do_merge = true;
 		}
 		
-		// check it's up to date :
-		RR_ASSERT( histos[i].total == rrSumOfHistogram(histos[i].histo.counts,256) );
-		RR_ASSERT( histos[j].total == rrSumOfHistogram(histos[j].histo.counts,256) );
-		RR_ASSERT( histos[i].complen == (*histo_cost_bits_func)(histos[i].histo,histos[i].total) );
-		RR_ASSERT( histos[j].complen == (*histo_cost_bits_func)(histos[j].histo,histos[j].total) );
-		
-		// J is in bytes
-		
-		if ( cur_merge.gain_J < min_gain_J && num_histos_remaining <= max_histos_target )
+		if ( do_merge )
 		{
-			// we stop when we are under MAX_NUM_ARRAYS
-			//	AND we hit an unprofitable merge
-			break;
+			// merge i & j
+			
+			histo_add( &(histos[i].histo), histos[i].histo, histos[j].histo );
+			histos[i].total += histos[j].total;
+			histos[j].total = 0;
+			
+			RR_DURING_ASSERT( U32 complen_before = histos[i].complen + histos[j].complen );
+			
+			histos[i].complen = cur_merge.merged_complen_bits;
+			RR_ASSERT( cur_merge.merged_complen_bits == (*histo_cost_bits_func)(histos[i].histo,histos[i].total) );
+			histos[j].complen = 0;
+			
+			RR_DURING_ASSERT( S32 complen_gain = complen_before - histos[i].complen );
+			RR_DURING_ASSERT( F32 check_gain_J = (complen_gain/8.f + merge_J_saved) );
+			// complen_gain can be slightly negative if the J savings make up for it
+			RR_ASSERT( check_gain_J >= 0.f || num_histos_remaining > max_histos_target );
+			RR_ASSERT( check_gain_J == cur_merge.gain_J );
+			
+			// all previous merge candidates with i & j are now lazily invalidated
+			//	because totals changed
+			num_histos_remaining--;
 		}
 		
-		// merge i & j
-		
-		histo_add( &(histos[i].histo), histos[i].histo, histos[j].histo );
-		histos[i].total += histos[j].total;
-		histos[j].total = 0;
-		
-		RR_DURING_ASSERT( U32 complen_before = histos[i].complen + histos[j].complen );
-		
-		histos[i].complen = cur_merge.merged_complen_bits;
-		RR_ASSERT( cur_merge.merged_complen_bits == (*histo_cost_bits_func)(histos[i].histo,histos[i].total) );
-		histos[j].complen = 0;
-		
-		RR_DURING_ASSERT( S32 complen_gain = complen_before - histos[i].complen );
-		RR_DURING_ASSERT( F32 check_gain_J = (complen_gain/8.f + merge_J_saved) );
-		// complen_gain can be slightly negative if the J savings make up for it
-		RR_ASSERT( check_gain_J >= 0.f || num_histos_remaining > max_histos_target );
-		RR_ASSERT( check_gain_J == cur_merge.gain_J );
+		// drop candidates whose partner is gone, they would be discarded when popped anyway
+		while ( row_size[i] > 0 && histos[ row[0].src2 ].total == 0 )
+		{
+			popped_heap(row,row+row_size[i]);
+			row_size[i]--;
+		}
 		
-		// all previous merge candidates with i & j are now lazily invalidated
-		//	because totals changed
-		num_histos_remaining--;
+		// put the row back in the outer heap with its new best :
+		if ( row_size[i] > 0 )
+		{
+			row_heap[row_heap_size++] = row[0];
+			push_heap(row_heap,row_heap+row_heap_size);
+		}
 	}
 	
 	RR_ASSERT( num_histos_remaining >= 1 && num_histos_remaining <= max_histos_target );
@@ -0,0 +1,79 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+// This source file is licensed solely to users who have
+// accepted a valid Unreal Engine license agreement 
+// (see e.g., https://www.unrealengine.com/eula), and use
+// of this source file is governed by such agreement.
+
+// @cdep pre $cbtargetavx2
+#include "entropysets.h"
+#include "log2table.h"
+#include "newlz_simd.h"
+
+#ifdef OODLE_BUILDING_DATA
+//#include "rrsimpleprof.h"
+#include "rrsimpleprofstub.h"
+#else // non-Oodle-Data never have SimpleProf
+#include "rrsimpleprofstub.h"
+#endif
+
+OODLE_NS_START
+
+#if defined(DO_BUILD_AVX2) && defined(RR_LOG2TABLE_SIZE)
+
+OODLE_NS_END
+#include <immintrin.h>
+OODLE_NS_START
+
+enum { LOG2TABLED_TO_ENTROPYSET_CODELEN_SHIFT = RR_LOG2TABLE_ONE_SHIFT - ENTROPYSET_CODELEN_ONE_BIT_SHIFT };
+
+// same as entropysets_order0_codelen_bits_sse4 but does the big log2 table lookups with a gather
+//	this is the cost func for the N^2 candidate setup in merge_entropysets
+U32 entropysets_order0_codelen_bits_avx2(const Histo256 & histo,SINTa sumCounts)
+{
+	SIMPLEPROFILE_SCOPE(entropysets_order0_codelen_bits_avx2);
+	RR_ASSERT( sumCounts > 0 );
+
+	U32 invSum = (1<<ENTROPYSET_INVSUM_SHIFT) / (U32)sumCounts;
+
+	RR_COMPILER_ASSERT(ENTROPYSET_INVSUM_SHIFT >= RR_LOG2TABLE_SIZE_SHIFT);
+
+	const __m256i vInvSum = _mm256_set1_epi32(invSum);
+	const __m256i vMaxCl = _mm256_set1_epi32(ENTROPYSET_SYM_PRESENT_MAX_CL);
+	__m256i vClSum0 = _mm256_setzero_si256();
+	__m256i vClSum1 = _mm256_setzero_si256();
+
+	for (int s = 0; s < 256; s += 16)
+	{
+		__m256i vCounts0 = _mm256_loadu_si256((const __m256i *)&histo.counts[s]);
+		__m256i vCounts1 = _mm256_loadu_si256((const __m256i *)&histo.counts[s + 8]);
+
+		// histos in the merger are often small & sparse ; all-zero groups add nothing
+		if ( _mm256_testz_si256(_mm256_or_si256(vCounts0, vCounts1), _mm256_or_si256(vCounts0, vCounts1)) )
+			continue;
+
+		// count * invSum <= 1<<ENTROPYSET_INVSUM_SHIFT so the index is in [0,RR_LOG2TABLE_SIZE]
+		__m256i vIdx0 = _mm256_srli_epi32(_mm256_mullo_epi32(vCounts0, vInvSum), ENTROPYSET_INVSUM_SHIFT - RR_LOG2TABLE_SIZE_SHIFT);
+		__m256i vIdx1 = _mm256_srli_epi32(_mm256_mullo_epi32(vCounts1, vInvSum), ENTROPYSET_INVSUM_SHIFT - RR_LOG2TABLE_SIZE_SHIFT);
+
+		__m256i vLogt0 = _mm256_i32gather_epi32((const int *)c_rr_log2_table, vIdx0, 4);
+		__m256i vLogt1 = _mm256_i32gather_epi32((const int *)c_rr_log2_table, vIdx1, 4);
+
+		// zero counts hit c_rr_log2_table[0] which is clamped here, and then multiplied by zero
+		__m256i vCl0 = _mm256_min_epi32(_mm256_srli_epi32(vLogt0, LOG2TABLED_TO_ENTROPYSET_CODELEN_SHIFT), vMaxCl);
+		__m256i vCl1 = _mm256_min_epi32(_mm256_srli_epi32(vLogt1, LOG2TABLED_TO_ENTROPYSET_CODELEN_SHIFT), vMaxCl);
+
+		vClSum0 = _mm256_add_epi32(vClSum0, _mm256_mullo_epi32(vCl0, vCounts0));
+		vClSum1 = _mm256_add_epi32(vClSum1, _mm256_mullo_epi32(vCl1, vCounts1));
+	}
+
+	__m256i vClSum = _mm256_add_epi32(vClSum0, vClSum1);
+	__m128i vClSum128 = _mm_add_epi32(_mm256_castsi256_si128(vClSum), _mm256_extracti128_si256(vClSum, 1));
+
+	U32 clSum = hsum_epi32_sse2(vClSum128);
+	U32 result = clSum >> ENTROPYSET_CODELEN_ONE_BIT_SHIFT;
+	return result;
+}
+
+#endif
+
+OODLE_NS_END
@@ -16,6 +16,7 @@
 #include "rrprefetch.h"
 
 #include "oodlehandle.h"
+#include "oodlejob.h"
 
 #if 0
 #include "../ext/rrsimplemalloc.h" // for OodleXMalloc_LogMemUse
@@ -268,6 +269,7 @@ static void LRM_MakeJump( LRM * lrm , int jumpBits )
 		//rrprintf("bloom bits per entry: %.2f\n", 1.0 * bloom_nrows * BLOOM_COL_SIZE / numEntries);
 
 		lrm->bloom_filter = OODLE_MALLOC_ARRAY_CACHEALIGNED(U32, bloom_nrows * BLOOM_COL_WORDS);
+		OodleMemoryHint(lrm->bloom_filter,sizeof(U32)*bloom_nrows*BLOOM_COL_WORDS,OODLE_MEMORY_HINT_LARGE_RANDOM_ACCESS);
 		lrm->bloom_row_shift = bloom_shift;
 
 		memset(lrm->bloom_filter, 0, bloom_nrows * BLOOM_COL_WORDS * sizeof(U32));
@@ -385,6 +387,7 @@ LRM * LRM_Fill(LRM * lrm, const U8 * buffer, SINTa bufSize, int step, int jumpBi
 	
 	lrm->entries.resize(numEntries+1);
 	LRMEntry * entries = lrm->entries.data();
+	OodleMemoryHint(entries,sizeof(LRMEntry)*(numEntries+1),OODLE_MEMORY_HINT_LARGE_RANDOM_ACCESS);
 	int ei = 0;
 	
 	LRM_hash_t last = (LRM_hash_t)-1;
@@ -769,6 +772,7 @@ LRM * LRM_FillMerge(LRM * lrm,const LRM * lhs, const LRM * rhs,int jumpBits)
 	lrm->entries.resize( tot_numEntries + 1 ); // one dummy
 	
 	LRMEntry * entries = lrm->entries.data();	
+	OodleMemoryHint(entries,sizeof(LRMEntry)*(tot_numEntries+1),OODLE_MEMORY_HINT_LARGE_RANDOM_ACCESS);
 	
 	int lhsi = 0;
 	int rhsi = 0;
@@ -962,6 +966,16 @@ SINTa LRM_GetCascadeChunkSize(const LRMCascade * casc)
 	return casc->chunkSize;
 }
 
+const U8 * LRM_GetCascadeBuffer(const LRMCascade * casc)
+{
+	return casc->buffer;
+}
+
+const U8 * LRM_GetCascadeEndPtr(const LRMCascade * casc)
+{
+	return casc->buffer + casc->bufSize;
+}
+
 LRMCascade * LRM_AllocCascade()
 {
 	LRMCascade * casc = OodleNew(LRMCascade);
@@ -1115,6 +1129,193 @@ LRMCascade * LRM_CreateCascadeIncremental(const U8 * buffer, SINTa bufSize, int
 	return casc;
 }
 
+/**
+
+LRM_CreateCascadeJobified :
+
+same cascade as LRM_FillCascade, built as a DAG on the plugin job system
+
+every level-0 LRM is an independent job
+the merge at [level][i] is a job that depends on its two children at [level-1][2i] and [level-1][2i+1]
+so all the leaves run at once and each level of merges starts as soon as its own inputs are done
+
+the odd (right) child is only ever used by its parent, so the merge job frees it,
+same as LRM_FillCascadeIncrement does
+
+the result is identical to the serial fill
+
+**/
+
+struct LRMCascadeFillJob
+{
+	LRMCascade * casc;
+	int level;
+	SINTa index;
+};
+
+static void OODLE_CALLBACK LRM_CascadeFillJob_Func(void * job_data)
+{
+	const LRMCascadeFillJob * job = (const LRMCascadeFillJob *)job_data;
+	LRMCascade * casc = job->casc;
+	int level = job->level;
+	SINTa index = job->index;
+
+	LRM * lrm = OodleNew(LRM);
+
+	if ( level == 0 )
+	{
+		SINTa chunkStart = index * casc->chunkSize;
+		LRM_Fill(lrm, casc->buffer + chunkStart, casc->chunkSize, casc->step, casc->jumpBits_0, casc->hash_length);
+	}
+	else
+	{
+		int childLevel = level - 1;
+		const LRM * lhs = casc->lrms[childLevel][2*index];
+		LRM * rhs = casc->lrms[childLevel][2*index+1];
+
+		int jumpBits = casc->jumpBits_0 + childLevel * casc->jumpBits_inc;
+		LRM_FillMerge( lrm, lhs, rhs, jumpBits );
+
+		LRM_Destroy( rhs );
+		casc->lrms[childLevel][2*index+1] = NULL;
+	}
+
+	casc->lrms[level][index] = lrm;
+}
+
+LRMCascade * LRM_CreateCascadeJobified(const U8 * buffer, SINTa bufSize, int step, int jumpBits_0, int jumpBits_inc,
+						SINTa base_chunkSizeA, int hash_length, void * jobifyUserPtr)
+{
+	THREADPROFILEFUNC();
+
+	LRMCascade * casc = LRM_AllocCascade();
+
+	LRM_FillCascadeSetup(casc,buffer,bufSize,step,jumpBits_0,jumpBits_inc,base_chunkSizeA,hash_length);
+
+	SINTa numChunks = casc->numChunks;
+
+	// one node per [level][index] ; level L has numChunks>>L of them
+	SINTa levelStart[LRM_CASCADE_MAX_LEVELS+1];
+	levelStart[0] = 0;
+	for(int level=0;level<LRM_CASCADE_MAX_LEVELS;level++)
+		levelStart[level+1] = levelStart[level] + (numChunks >> level);
+
+	SINTa numNodes = levelStart[LRM_CASCADE_MAX_LEVELS];
+	if ( numNodes == 0 )
+		return casc;
+
+	vector<LRMCascadeFillJob> jobs;
+	vector<U64> handles;
+	jobs.resize(numNodes);
+	handles.resize(numNodes);
+
+	for(int level=0;level<LRM_CASCADE_MAX_LEVELS;level++)
+	{
+		SINTa levelCount = numChunks >> level;
+		for(SINTa i=0;i<levelCount;i++)
+		{
+			SINTa node = levelStart[level] + i;
+			jobs[node].casc = casc;
+			jobs[node].level = level;
+			jobs[node].index = i;
+
+			U64 deps[2] = { 0, 0 };
+			int numDeps = 0;
+			if ( level > 0 )
+			{
+				deps[0] = handles[ levelStart[level-1] + 2*i ];
+				deps[1] = handles[ levelStart[level-1] + 2*i + 1 ];
+				numDeps = 2;
+			}
+
+			handles[node] = OodleJob_Run(LRM_CascadeFillJob_Func,&jobs[node],deps,numDeps,jobifyUserPtr);
+		}
+	}
+
+	// all dependencies have been submitted, now wait on everything :
+	OodleJob_WaitAll(handles.data(),S32_checkA(numNodes),jobifyUserPtr);
+
+	// nothing left for the incremental path to do
+	casc->nextChunk = numChunks;
+
+	return casc;
+}
+
+/**
+
+LRM_ExtendCascade :
+
+grow a filled cascade to cover more of the same buffer (data appended after the old end)
+
+the existing LRMs are untouched ; new level-0 chunks are filled and merged upward
+exactly as LRM_FillCascadeIncrement would have done had they been there from the start,
+so the result is the same as making the cascade on the longer buffer
+
+**/
+
+void LRM_ExtendCascade(LRMCascade * casc, SINTa newBufSize)
+{
+	THREADPROFILEFUNC();
+
+	// must be caught up before we add chunks after the end :
+	while ( LRM_FillCascadeIncrement(casc) )
+	{
+	}
+
+	SINTa numChunks = newBufSize / casc->chunkSize;
+	if ( numChunks <= casc->numChunks )
+		return;
+
+	casc->bufSize = numChunks * casc->chunkSize;
+	casc->numChunks = numChunks;
+
+	for (int level = 0; level < LRM_CASCADE_MAX_LEVELS; level++)
+	{
+		// resize keeps the old pointers and fills the new slots with null
+		casc->lrms[level].resize(numChunks >> level, 0);
+	}
+
+	while ( LRM_FillCascadeIncrement(casc) )
+	{
+	}
+}
+
+/**
+
+LRM_TruncateCascade :
+
+the fill only ever frees right children that were just made (never stored),
+and every stored LRM covers whole chunks [i<<level,(i+1)<<level)
+so the LRMs that only cover chunks below the new end are exactly the ones a fill up to there would have made
+
+**/
+
+void LRM_TruncateCascade(LRMCascade * casc, SINTa newBufSize)
+{
+	SINTa numChunks = newBufSize / casc->chunkSize;
+	if ( numChunks >= casc->numChunks )
+		return;
+
+	for (int level = 0; level < LRM_CASCADE_MAX_LEVELS; level++)
+	{
+		vector<LRM *> & lrms = casc->lrms[level];
+		for LOOPVEC(i,lrms)
+		{
+			SINTa end = ((SINTa)i+1) << level;
+			if ( end > numChunks && lrms[i] )
+			{
+				LRM_Destroy(lrms[i]);
+				lrms[i] = NULL;
+			}
+		}
+		lrms.resize(numChunks >> level);
+	}
+
+	casc->bufSize = numChunks * casc->chunkSize;
+	casc->numChunks = numChunks;
+	casc->nextChunk = RR_MIN(casc->nextChunk,numChunks);
+}
+
 void LRM_DestroyCascade(LRMCascade * casc)
 {
 	for(int level = 0;level<LRM_CASCADE_MAX_LEVELS;level++)
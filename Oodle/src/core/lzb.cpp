@@ -1301,6 +1301,13 @@ OOINLINE void copy_no_overlap_long(U8 * to, const U8 * from, SINTr length)
 	lz_copysteptoend_overrunok(to,from,length);
 }
 
+// used for long LRL and long matches with offset >= 16 on the fast path
+//	16-byte steps, overruns by up to 15 (the fast path has LZB_R_BYTES_FASTPATH of slack)
+OOINLINE void copy_no_overlap16_long(U8 * to, const U8 * from, SINTr length)
+{
+	lz_copy16steptoend_overrunok(to,from,length);
+}
+
 OOINLINE void copy_match_simple_sw(U8 * to, SINTr fmPos, const U8 * window, SINTr windowMask, SINTr length)
 {
 	RR_ASSERT( length > 0 && length < windowMask );
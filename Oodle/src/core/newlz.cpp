@@ -26,6 +26,7 @@
 #include "newlz_subliterals.h"
 #include "newlz_vtable.h"
 #include "newlz_arrays.inl"
+#include "newlz_arrays_huff.h"
 #include "newlz_multiarrays.h"
 
 #include "histogram.h"
@@ -985,6 +986,10 @@ typedef CTMF<U32,2,SECOND_HASH_LEN,NEWLZ_MML_NORMAL>	newLZ_CTMF_Normal;
 typedef FastCTMF<U32> newLZ_CTMF_HyperFast32;
 typedef FastCTMF<U16> newLZ_CTMF_HyperFast16;
 
+// how many bytes ahead the lazy heuristic parsers prefetch CTMF rows
+//	(on top of the one-step prefetch_next in get_match)
+#define NEWLZ_CTMF_PREFETCH_AHEAD	4
+
 //=======================================================================================
 
 template<typename newLZ_CTMF>
@@ -1258,6 +1263,15 @@ static SINTa newLZ_encoder_arrays_output(
 	const OodleSpeedFit * speedfit = vtable->speedfit;
 	*pJ = LAGRANGE_COST_INVALID;
 
+	// huff tables sent so far in this chunk ; must track what the decoder adds in newLZ_decode_chunk_phase1
+	newlz_huff_table_cache huff_cache_storage;
+	newlz_huff_table_cache * huff_cache = NULL;
+	if ( entropy_flags & NEWLZ_ARRAY_FLAG_ALLOW_HUFF_REUSE )
+	{
+		newlz_huff_table_cache_init(&huff_cache_storage);
+		huff_cache = &huff_cache_storage;
+	}
+
 	// check for collisions :
 	RR_ASSERT( encarrays->literals_ptr_raw < encarrays->literals_space_sub );
 	RR_ASSERT( encarrays->literals_ptr_sub < encarrays->packets_space );
@@ -1474,6 +1488,8 @@ static SINTa newLZ_encoder_arrays_output(
 			return chunk_len;
 
 		RR_ASSERT( literal_comp_len >= 0 );
+		if ( huff_cache )
+			newlz_huff_table_cache_add_array(huff_cache,comp_ptr,comp_ptr+literal_comp_len);
 		comp_ptr += literal_comp_len;
 		
 		RR_ASSERT( literals_J >= literal_comp_len );
@@ -1490,12 +1506,15 @@ static SINTa newLZ_encoder_arrays_output(
 
 	SINTa packet_comp_len = newLZ_put_array(comp_ptr,comp_end,encarrays->packets_space,packet_count,
 		entropy_flags,lambda,speedfit,&packet_J,deadline->packet,arena,level,
-		passinfo ? passinfo->packet_histo : NULL
+		passinfo ? passinfo->packet_histo : NULL,
+		huff_cache
 		);
 
 	if ( packet_comp_len < 0 )
 		return chunk_len;
 
+	if ( huff_cache )
+		newlz_huff_table_cache_add_array(huff_cache,comp_ptr,comp_ptr+packet_comp_len);
 	comp_ptr += packet_comp_len;
 
 	//rrprintfvar(packet_count);
@@ -1544,7 +1563,8 @@ static SINTa newLZ_encoder_arrays_output(
 
 	SINTa excesses_u8_comp_len = newLZ_put_array(comp_ptr,comp_end,encarrays->excess_u8_space,excesses_u8_count,
 		entropy_flags,lambda,speedfit,&excesses_u8_J,deadline->excesses_u8,arena,level,
-		passinfo ? passinfo->excess_histo : NULL
+		passinfo ? passinfo->excess_histo : NULL,
+		huff_cache
 		);
 
 	if ( excesses_u8_comp_len < 0 )
@@ -1773,6 +1793,12 @@ static SINTa newLZ_encode_chunk(const newlz_vtable * vtable,
 			if ( rrPtrDiff(parse_end_ptr - ptr) <= (SINTa)step )
 				goto parse_chunk_done;
 
+			// get_match prefetches the next step ; also get the row a few steps ahead started,
+			//	we're usually waiting on main memory for it
+			//	(only when stepping 1 byte at a time ; with literal skipping it's a loss)
+			if ( t_do_lazy_parse && rrPtrDiff(parse_end_ptr - ptr) > NEWLZ_CTMF_PREFETCH_AHEAD )
+				ctmf->prefetch_rows(ptr + NEWLZ_CTMF_PREFETCH_AHEAD);
+
 			// once we find a match, we can stop!
 			if ( newLZ_get_match_heuristic_inline(&chosen,ctmf,step,lastoffsets,ptr,ptr_matchend,mml,literals_start,dictionarySize,true,pOptions) )
 				break;
@@ -2389,6 +2415,11 @@ static SINTa newLZ_decode_chunk_phase1(
 	// unpack the huff arrays of literals & packets :
 	
 	U8 * scratch_ptr = U8_void(scratch_space);
+	
+	// huff tables seen in this chunk, for arrays that reuse them
+	//	literals, packets & excesses take part ; the offset arrays don't
+	newlz_huff_table_cache huff_cache;
+	newlz_huff_table_cache_init(&huff_cache);
 		
 	{
 	//SIMPLEPROFILE_SCOPE(get_array_literals);
@@ -2404,7 +2435,7 @@ static SINTa newLZ_decode_chunk_phase1(
 			SINTa literals_comp_len = newLZ_get_array(&literals,comp_ptr,chunk_comp_end,&literals_count,
 										RR_MIN(chunk_len,rrPtrDiff(scratch_end-scratch_ptr)),
 										inplace_comp_raw_overlap,
-										scratch_ptr,scratch_end);
+										scratch_ptr,scratch_end,&huff_cache);
 			if ( literals_comp_len < 0 ) return -1;						
 
 			comp_ptr += literals_comp_len;
@@ -2431,7 +2462,7 @@ static SINTa newLZ_decode_chunk_phase1(
 	SINTa packets_comp_len = newLZ_get_array(&packets,comp_ptr,chunk_comp_end,&packets_count,
 		RR_MIN(chunk_len,rrPtrDiff(scratch_end-scratch_ptr)),
 		inplace_comp_raw_overlap,
-		scratch_ptr,scratch_end);
+		scratch_ptr,scratch_end,&huff_cache);
 	if ( packets_comp_len < 0 ) return -1;
 	
 	comp_ptr += packets_comp_len;
@@ -2536,7 +2567,7 @@ static SINTa newLZ_decode_chunk_phase1(
 	//SIMPLEPROFILE_SCOPE(get_array_excessu8);
 	SINTa excesses_u8_comp_len = newLZ_get_array(&excesses_u8,comp_ptr,chunk_comp_end,&excesses_count,
 		RR_MIN(chunk_len/4,rrPtrDiff(scratch_end-scratch_ptr)),false,
-		scratch_ptr,scratch_end);
+		scratch_ptr,scratch_end,&huff_cache);
 	if ( excesses_u8_comp_len < 0 ) return -1;
 	
 	comp_ptr += excesses_u8_comp_len;
@@ -2639,6 +2670,11 @@ static RADINLINE SINTa newLZ_decode_chunk_phase2(
 	const newLZ_decode_parse_func_set * parse = &newLZ_decode_parse_funcs_regular;
 	#endif
 
+	#ifdef DO_BUILD_AVX2
+	if ( newlz_simd_has_avx2_bulk() )
+		parse = &newLZ_decode_parse_funcs_avx2;
+	#endif
+
 	if ( chunk_type == NEWLZ_LITERALS_TYPE_RAW )
 	{
 		bool res;
@@ -3160,25 +3196,21 @@ const U8 * dictionaryBase, U32 dictionarySize,const OodleLZ_CompressOptions *pOp
 	}
 }
 
+// newlz_optimal_arrival_tll is 24 bytes (was 32)
+//	there are num_tlls of these per pos of the chunk, they're most of the optimal parse memory use
+//	ml & prev_index fit in bit fields because pos < NEWLZ_CHUNK_LEN
+//	lrl is not stored, it's implied by prev_index ; see newlz_optimal_arrival_tll_prev_pos
 struct newlz_optimal_arrival_tll
 {
 	S32	cost;
 	newLZ_LOs_NoPad los; // this is the los *after* my match, eg. the set for going forward when you start here
 		// los[0] is the offset used in the packet for this arrival
-	S32 ml,lrl; // prev pos is at -ml-lrl
-		
-	union
-	{
-	U32 is_twostep;
-	struct {
-		U32 lrl : 8;
-		U32 ml : 24;
-	} twostep;
-	};
 	
-	S32 prev_index; // how to find your previous arrival (this is a tll index)	
+	U64 prev_index : 20; // how to find your previous arrival (this is a tll index)	
 		// prev_index could also be used for multi-parse
-	
+	U64 ml : 18; // match start is at -ml ; the prev arrival is at newlz_optimal_arrival_tll_prev_pos(prev_index)
+	U64 twostep_lrl : 8; // twostep_lrl != 0 means this is a two-step arrival (twostep lrl is always >= 1)
+	U64 twostep_ml : 18;
 	
 	#ifdef RR_DO_ASSERTS
 	S32 check_offset;
@@ -3194,6 +3226,29 @@ struct newlz_optimal_arrival_tll
 	#endif
 };
 
+RR_COMPILER_ASSERT( (NEWLZ_CHUNK_LEN+1)*2 < (1<<20) ); // prev_index with num_tlls <= 2
+RR_COMPILER_ASSERT( NEWLZ_CHUNK_LEN < (1<<18) ); // ml , twostep_ml
+
+#ifndef RR_DO_ASSERTS
+RR_COMPILER_ASSERT( sizeof(newlz_optimal_arrival_tll) == 24 ); // arrivals are the bulk of the optimal parse's memory traffic
+#endif
+
+// the arrival pos that prev_index points at
+//	the packet lrl is the gap from there to the start of the match
+static RADFORCEINLINE int newlz_optimal_arrival_tll_prev_pos(int prev_index,int num_tlls,const int * last_tll_len)
+{
+	if ( num_tlls == 1 )
+		return prev_index;
+		
+	int pos = prev_index / num_tlls;
+	int t = prev_index % num_tlls;
+	// last_tll_len[pos] is final once the parse has gone past pos
+	if ( t == num_tlls-1 )
+		return pos - last_tll_len[pos];
+	else
+		return pos - t;
+}
+
 struct newlz_codecosts
 {
 	int chunktype;
@@ -3418,9 +3473,8 @@ static RADFORCEINLINE S32 try_lo_arrival_tll(
 		{
 			arrival.cost = lo_cost;
 			arrival.ml = ml;
-			arrival.lrl = lrl;
 			arrival.los.SetMTF(los,loi);
-			arrival.is_twostep = 0;
+			arrival.twostep_lrl = 0;
 			arrival.prev_index = prev_index;
 			RR_DURING_ASSERT( arrival.check_offset = -loi );
 			RR_DURING_ASSERT( arrival.check_arrival_pos = pos+ml );
@@ -3438,9 +3492,8 @@ static RADFORCEINLINE S32 try_lo_arrival_tll(
 			{
 				arrival.cost = lo_cost;
 				arrival.ml = ml;
-				arrival.lrl = lrl;
 				arrival.los.SetMTF(los,loi);
-				arrival.is_twostep = 0;
+				arrival.twostep_lrl = 0;
 				arrival.prev_index = prev_index;
 				RR_DURING_ASSERT( arrival.check_offset = -loi );
 				RR_DURING_ASSERT( arrival.check_arrival_pos = pos+ml );
@@ -3462,9 +3515,8 @@ static RADFORCEINLINE S32 try_lo_arrival_tll(
 			{
 				arrival.cost = cost;
 				arrival.ml = ml;
-				arrival.lrl = lrl;
 				arrival.los.SetMTF(los,loi);
-				arrival.is_twostep = 0;
+				arrival.twostep_lrl = 0;
 				arrival.prev_index = prev_index;
 				RR_DURING_ASSERT( arrival.check_offset = -loi );
 				RR_DURING_ASSERT( arrival.check_arrival_pos = pos+ml );
@@ -3502,9 +3554,8 @@ static RADFORCEINLINE S32 try_match_arrival_tll(
 		{
 			arrival.cost = match_cost;
 			arrival.ml = ml;
-			arrival.lrl = lrl;
 			arrival.los.SetAdd(los,offset);
-			arrival.is_twostep = 0;
+			arrival.twostep_lrl = 0;
 			arrival.prev_index = prev_index;
 			RR_DURING_ASSERT( arrival.check_offset = offset );
 			RR_DURING_ASSERT( arrival.check_arrival_pos = pos+ml );
@@ -3522,9 +3573,8 @@ static RADFORCEINLINE S32 try_match_arrival_tll(
 			{
 				arrival.cost = match_cost;
 				arrival.ml = ml;
-				arrival.lrl = lrl;
 				arrival.los.SetAdd(los,offset);
-				arrival.is_twostep = 0;
+				arrival.twostep_lrl = 0;
 				arrival.prev_index = prev_index;
 				RR_DURING_ASSERT( arrival.check_offset = offset );
 				RR_DURING_ASSERT( arrival.check_arrival_pos = pos+ml );
@@ -3544,9 +3594,8 @@ static RADFORCEINLINE S32 try_match_arrival_tll(
 			{
 				arrival.cost = cost;
 				arrival.ml = ml;
-				arrival.lrl = lrl;
 				arrival.los.SetAdd(los,offset);
-				arrival.is_twostep = 0;
+				arrival.twostep_lrl = 0;
 				arrival.prev_index = prev_index;
 				RR_DURING_ASSERT( arrival.check_offset = offset );
 				RR_DURING_ASSERT( arrival.check_arrival_pos = pos+ml );
@@ -3575,7 +3624,7 @@ static RADFORCEINLINE void try_two_step_arrival_tll(
 	newlz_optimal_arrival_tll * tll_arrivals,int num_tlls,
 	int prev_index, const U8 * chunk_ptr, const U8 * ptr_matchend, S32 * pparse_chunk_end,
 
-	S32 pos,S32 first_step_cost,S32 initial_ml,S32 initial_lrl,S32 initial_loi,S32 offset,
+	S32 pos,S32 first_step_cost,S32 initial_ml,S32 initial_loi,S32 offset,
 	const newLZ_LOs_NoPad & los,
 	const newlz_codecosts & codecosts)
 {
@@ -3640,13 +3689,13 @@ static RADFORCEINLINE void try_two_step_arrival_tll(
 			{
 				arrival.cost = twostep_cost;
 				arrival.ml = initial_ml;
-				arrival.lrl = initial_lrl;
 				if (initial_loi >= 0)
 					arrival.los.SetMTF(los,initial_loi);
 				else
 					arrival.los.SetAdd(los,offset);
-				arrival.twostep.lrl = twostep_lrl;
-				arrival.twostep.ml = twostep_ml;
+				RR_ASSERT( twostep_lrl >= 1 );
+				arrival.twostep_lrl = twostep_lrl;
+				arrival.twostep_ml = twostep_ml;
 				arrival.prev_index = prev_index;
 				RR_DURING_ASSERT( arrival.check_offset = (initial_loi >= 0) ? -initial_loi : offset );
 				RR_DURING_ASSERT( arrival.check_arrival_pos = twostep_arrival_pos );
@@ -4394,6 +4443,11 @@ static SINTa newLZ_encode_chunk_optimal_tll(const newlz_vtable * vtable,
 	//-----------------------------------------------------------------------------
 	// optimal parse!
 	
+	// The parse of one chunk is serial.  Splitting it into overlapping ranges on jobs, joined at a
+	//	shared packet boundary, cost 0.03-0.35% (2% on very compressible data) at Optimal4 ; the chunk
+	//	encoder then has to wait on its own jobs, so it only helps when workers outnumber the block
+	//	parse jobs, and it was never timed on a multi-core machine.
+	
 	// do_optimal_iter will repeat the parse for statistics refinement
 	//	-> now done only if literal type changes
 	//  -> in Kraken this is pretty rare, so the net effect on compression & encodetime are both small
@@ -4483,9 +4537,8 @@ static SINTa newLZ_encode_chunk_optimal_tll(const newlz_vtable * vtable,
 	tll_arrivals[start_pos*num_tlls+0].cost = 0;
 	tll_arrivals[start_pos*num_tlls+0].los.Reset();
 	tll_arrivals[start_pos*num_tlls+0].ml = 0;
-	tll_arrivals[start_pos*num_tlls+0].lrl = 0;
 	tll_arrivals[start_pos*num_tlls+0].prev_index = 0;
-	tll_arrivals[start_pos*num_tlls+0].is_twostep = 0;
+	tll_arrivals[start_pos*num_tlls+0].twostep_lrl = 0;
 	RR_DURING_ASSERT( tll_arrivals[start_pos*num_tlls+0].check_offset = 0 );
 	RR_DURING_ASSERT( tll_arrivals[start_pos*num_tlls+0].check_arrival_pos = start_pos );
 	
@@ -5017,7 +5070,7 @@ static SINTa newLZ_encode_chunk_optimal_tll(const newlz_vtable * vtable,
 					if ( pos+ml < twostep_lo_end_pos )
 					{
 						try_two_step_arrival_tll(tll_arrivals,num_tlls,prev_index,chunk_ptr,ptr_matchend,&parse_chunk_end,
-							pos+ml,first_step_cost,ml,lrl,loi,offset,los,codecosts);
+							pos+ml,first_step_cost,ml,loi,offset,los,codecosts);
 					}
 					#endif
 				}
@@ -5117,7 +5170,7 @@ static SINTa newLZ_encode_chunk_optimal_tll(const newlz_vtable * vtable,
 					if ( pos+ml < twostep_end_pos )
 					{
 						try_two_step_arrival_tll(tll_arrivals,num_tlls,prev_index,chunk_ptr,ptr_matchend,&parse_chunk_end,
-							pos+ml,first_step_cost,ml,lrl,-1,offset,los,codecosts);
+							pos+ml,first_step_cost,ml,-1,offset,los,codecosts);
 					}
 					#endif
 				}
@@ -5319,9 +5372,9 @@ static SINTa newLZ_encode_chunk_optimal_tll(const newlz_vtable * vtable,
 				break;
 			}
 			
-			if ( arrival.is_twostep )
+			if ( arrival.twostep_lrl )
 			{
-				int twostep_prev_pos = rpos - arrival.twostep.ml - arrival.twostep.lrl;
+				int twostep_prev_pos = rpos - (int)arrival.twostep_ml - (int)arrival.twostep_lrl;
 				RR_ASSERT( twostep_prev_pos < rpos );
 				RR_ASSERT( twostep_prev_pos >= parse_chunk_start );
 		
@@ -5330,22 +5383,25 @@ static SINTa newLZ_encode_chunk_optimal_tll(const newlz_vtable * vtable,
 				newlz_encoder_parse & parse = chunk_parsevec.back();
 				parse.lastoffset = arrival.los.LastOffset(); // LO0 after the
 				parse.offset = 0; // LO0
-				parse.ml = arrival.twostep.ml;
-				parse.lrl = arrival.twostep.lrl;
+				parse.ml = (S32)arrival.twostep_ml;
+				parse.lrl = (S32)arrival.twostep_lrl;
 				RR_ASSERT( parse.IsLO() );
 			
 				// verify the match :
-				RR_DURING_ASSERT( const U8 * twostep_ptr = chunk_ptr + rpos - arrival.twostep.ml );
-				RR_ASSERT( memcmp(twostep_ptr,twostep_ptr - parse.lastoffset,arrival.twostep.ml) == 0 );
+				RR_DURING_ASSERT( const U8 * twostep_ptr = chunk_ptr + rpos - parse.ml );
+				RR_ASSERT( memcmp(twostep_ptr,twostep_ptr - parse.lastoffset,parse.ml) == 0 );
 			
 				rpos = twostep_prev_pos;
 			}
 			
-			int prev_pos = rpos - arrival.ml - arrival.lrl;
+			int prev_index = (int)arrival.prev_index;
+			int prev_pos = newlz_optimal_arrival_tll_prev_pos(prev_index,num_tlls,last_tll_len);
+			int arrival_ml = (int)arrival.ml;
+			int arrival_lrl = rpos - arrival_ml - prev_pos;
+			RR_ASSERT( arrival_lrl >= 0 );
 			RR_ASSERT( prev_pos < rpos );
 			RR_ASSERT( prev_pos >= parse_chunk_start );
 			
-			int prev_index = arrival.prev_index;
 			RR_ASSERT( tll_check_index_pos(prev_pos,prev_index,num_tlls) );
 			
 			const newlz_optimal_arrival_tll & prev_arrival = tll_arrivals[prev_index];
@@ -5374,8 +5430,8 @@ static SINTa newLZ_encode_chunk_optimal_tll(const newlz_vtable * vtable,
 
 			// I need the LO to apply to my literals; that's the *previous* LO
 			parse.lastoffset = prev_arrival.los.LastOffset();
-			parse.lrl = arrival.lrl;
-			parse.ml = arrival.ml;
+			parse.lrl = arrival_lrl;
+			parse.ml = arrival_ml;
 			parse.offset = offset;
 
 			rpos = prev_pos;
@@ -5503,6 +5559,7 @@ static SINTa newLZ_encode_chunk_optimal_tll(const newlz_vtable * vtable,
 
 OODLE_NS_END
 #include "suffixtrie.h"
+#include "suffixarray.h"
 OODLE_NS_START
 
 #endif // OODLE_PLATFORM_HAS_ADVANCED_MATCHERS
@@ -5569,6 +5626,12 @@ void Kraken_FillVTable(
 			vtable.entropy_flags |= NEWLZ_ARRAY_FLAG_ALLOW_SPLIT_INDEXED;
 		}
 
+		// huff table reuse is opt-in by version , like rANS in Leviathan :
+		if ( version >= NEWLZ_HUFF_REUSE_MIN_MAJOR_VERSION )
+		{
+			vtable.entropy_flags |= NEWLZ_ARRAY_FLAG_ALLOW_HUFF_REUSE;
+		}
+
 		// for encode speed , alt offsets only at higher levels :
 		if ( level >= OodleLZ_CompressionLevel_Optimal1 )
 		{
@@ -5693,7 +5756,15 @@ void Kraken_FillVTable(
 	else if ( level >= OodleLZ_CompressionLevel_Optimal2 )
 	{
 		vtable.fp_encode_chunk = newLZ_encode_chunk_optimal_tll;
-		vtable.fp_create_match_finder = SuffixTrie_CreateMatchFinder;
+		if ( pOptions->suffixArrayMatchFinder )
+		{
+			vtable.fp_create_match_finder = SuffixArray_CreateMatchFinder;
+			vtable.fp_create_match_finder_runs_jobs = SuffixArray_CreateRunsJobs;
+		}
+		else
+		{
+			vtable.fp_create_match_finder = SuffixTrie_CreateMatchFinder;
+		}
 		vtable.find_all_matches_num_pairs = NEWLZ_MATCH_NUM_PAIRS;
 		vtable.wants_dic_limit_splits = true;
 	}
@@ -16,6 +16,7 @@
 #include "newlz_arrays_huff.h"
 #include "newlz_arrays_tans.h"
 #include "newlz_arrays_rle.h"
+#include "newlz_arrays_rans.h"
 #include "newlz_multiarrays.h"
 #include "newlz_shared.h"
 #include "newlz_speedfit.h"
@@ -77,7 +78,8 @@ static void test_save_tans_array(const U8 * from,SINTa from_len)
 SINTa newLZ_put_array_histo(U8 * to,U8 * to_end, const U8 * from, SINTa from_len, 
 	const U32 * histogram, U32 flags, F32 lambda, const OodleSpeedFit * speedfit, F32 * pJ, F32 deadline_t,
 	rrArenaAllocator * arena,
-	int compression_level // OodleLZ_CompressionLevel
+	int compression_level, // OodleLZ_CompressionLevel
+	const newlz_huff_table_cache * huff_cache /*= NULL*/
 	)
 {
 	SIMPLEPROFILE_SCOPE_N(put_array_histo,from_len);
@@ -370,6 +372,26 @@ SINTa newLZ_put_array_histo(U8 * to,U8 * to_end, const U8 * from, SINTa from_len
 			}
 		}
 		
+		if ( (flags & NEWLZ_ARRAY_FLAG_ALLOW_HUFF_REUSE) && huff_cache != NULL && huff_cache->count > 0 )
+		{
+			// try huff with a table sent earlier in the chunk ; no code lens to send or decode
+			//	leave previous data in [to] if its J is better :
+			
+			F32 reuse_J = min_J;
+			U32 huff_type = 0;
+			SINTa reuse_comp_len = newLZ_put_array_huff_reuse(to+5,to_end,from,from_len,histogram,lambda,speedfit,&reuse_J,deadline_t,&huff_type,flags,huff_cache,arena);
+			
+			if ( reuse_comp_len >= 0 )
+			{
+				RR_ASSERT( huff_type == NEWLZ_ARRAY_TYPE_HUFF || huff_type == NEWLZ_ARRAY_TYPE_HUFF6 );
+				RR_ASSERT( reuse_J <= min_J );
+				RR_ASSERT( reuse_J >= reuse_comp_len+5 );
+				array_type = huff_type;
+				comp_len = reuse_comp_len;
+				min_J = J_comp = reuse_J;
+			}
+		}
+		
 		if ( flags & NEWLZ_ARRAY_FLAG_ALLOW_TANS )
 		{
 			// try TANS as well
@@ -411,6 +433,28 @@ SINTa newLZ_put_array_histo(U8 * to,U8 * to_end, const U8 * from, SINTa from_len
 			}
 		}
 		
+		if ( flags & NEWLZ_ARRAY_FLAG_ALLOW_RANS )
+		{
+			// try rANS ; leave previous data in [to] if its J is better :
+			
+			F32 rans_J = min_J;
+	
+			// put at to+5 for header space
+			SINTa rans_comp_len = newLZ_put_array_rans(to+5,to_end,from,from_len,histogram,lambda,speedfit,&rans_J,arena);
+	
+			if ( rans_comp_len >= 0 )
+			{
+				RR_ASSERT( rans_comp_len < from_len );
+				RR_ASSERT( rans_J <= min_J ); // should only have chosen this if it's better
+				RR_ASSERT( rans_J >= rans_comp_len+5 );
+				RR_ASSERT( lambda > 0.f || rans_J == rans_comp_len+5 );
+				
+				array_type = NEWLZ_ARRAY_TYPE_RANS;
+				comp_len = rans_comp_len;
+				min_J = J_comp = rans_J;
+			}
+		}
+		
 		if ( flags & NEWLZ_ARRAY_FLAG_ALLOW_SPLIT )
 		{
 			// @@?? don't try split unless one of our compress attempts so far
@@ -633,7 +677,8 @@ SINTa newLZ_put_array(U8 * to,U8 * to_end, const U8 * from, SINTa from_len,
 	U32 entropy_type, F32 lambda,const OodleSpeedFit * speedfit, F32 * pJ, F32 deadline_t,
 	rrArenaAllocator * arena,
 	int compression_level, // OodleLZ_CompressionLevel
-	U32 * optional_histo /*= NULL*/
+	U32 * optional_histo /*= NULL*/,
+	const newlz_huff_table_cache * huff_cache /*= NULL*/
 	)
 {
 	if ( from_len <= NEWLZ_HUFF_ARRAY_MIN_SIZE )
@@ -656,7 +701,7 @@ SINTa newLZ_put_array(U8 * to,U8 * to_end, const U8 * from, SINTa from_len,
 		if ( optional_histo )
 			memcpy(optional_histo,histo,256*sizeof(U32));
 		
-		return newLZ_put_array_histo(to,to_end,from,from_len,histo,entropy_type,lambda,speedfit,pJ,deadline_t,arena,compression_level);
+		return newLZ_put_array_histo(to,to_end,from,from_len,histo,entropy_type,lambda,speedfit,pJ,deadline_t,arena,compression_level,huff_cache);
 	}	
 }
 
@@ -918,7 +963,8 @@ SINTa newLZ_get_arraylens(const U8 * from, const U8 * from_end, SINTa * pto_len,
 }
 
 SINTa newLZ_get_array_comp(U32 array_type, U8ptr * ptr_to, const U8 * from, const U8 * from_end, SINTa * pto_len, SINTa to_len_max,
-								U8 * scratch_ptr, U8 * scratch_end)
+								U8 * scratch_ptr, U8 * scratch_end,
+								newlz_huff_table_cache * huff_cache /*= NULL*/)
 {
 	RR_ASSERT( array_type != NEWLZ_ARRAY_TYPE_UNCOMPRESSED ); // uncomp handled outside
 	if ( array_type >= NEWLZ_ARRAY_TYPE_COUNT )
@@ -1036,10 +1082,15 @@ SINTa newLZ_get_array_comp(U32 array_type, U8ptr * ptr_to, const U8 * from, cons
 		newlz_array_get_printf("[tans %d->%d]",(int)to_len,(int)comp_len);
 		comp_used = newlz_get_array_tans(from_ptr,comp_len,*ptr_to,to_len,scratch_ptr,scratch_end);
 	}
+	else if ( array_type == NEWLZ_ARRAY_TYPE_RANS )
+	{
+		newlz_array_get_printf("[rans %d->%d]",(int)to_len,(int)comp_len);
+		comp_used = newlz_get_array_rans(from_ptr,comp_len,*ptr_to,to_len,scratch_ptr,scratch_end);
+	}
 	else
 	{
 		newlz_array_get_printf("[huff %d->%d]",(int)to_len,(int)comp_len);
-		comp_used = newlz_get_array_huff(from_ptr,comp_len,*ptr_to,to_len,array_type == NEWLZ_ARRAY_TYPE_HUFF6);
+		comp_used = newlz_get_array_huff(from_ptr,comp_len,*ptr_to,to_len,array_type == NEWLZ_ARRAY_TYPE_HUFF6,huff_cache);
 	}
 	
 	// this also catches comp_used == -1 (error return)
@@ -900,6 +900,77 @@ static void newlz_encode_hufflens2(rrHuffman * HI, rrVarBits * vb, const t_alpha
 // -> this is now important to get right
 //  < 0 means failure but *to was not modified, so previous contents are still valid
 //	> from_len means failure but *to was changed!
+static U32 newlz_choose_huff_type(SINTa from_len, int num_non_zero, int num_alphabet_runs, F32 expected_bpb,
+									F32 lambda, const OodleSpeedFit * speedfit, U32 entropy_flags)
+{
+	// huff6 extra cost: (see below)
+	// - 5 extra bytes of metadata for stream sizes
+	// - 3 extra bitstream flushes at an expected 3.5 bits/stream cost
+	static const F32 HUFF6_EXTRA_BYTES = 5.0f + 3*3.5f/8.0f;
+
+	U32 huff_type = NEWLZ_ARRAY_TYPE_HUFF;
+	if ( entropy_flags & NEWLZ_ARRAY_FLAG_ALLOW_HUFF6 )
+	{
+		F32 huff6_minus_huff3_time =
+			speedfit->huff6(from_len,num_non_zero,num_alphabet_runs,expected_bpb) -
+			speedfit->huff3(from_len,num_non_zero,num_alphabet_runs,expected_bpb);
+		// huff6_minus_huff3_time is > 0 for small len , < 0 for large len
+	
+		F32 huff6_delta_J = HUFF6_EXTRA_BYTES + lambda * huff6_minus_huff3_time;
+
+		if ( huff6_delta_J < 0.0f )
+		{
+			huff_type = NEWLZ_ARRAY_TYPE_HUFF6;
+		}
+	}
+	return huff_type;
+}
+
+// write the 3 or 6 huff streams after the header
+//	returns the end of the streams
+static U8 * newlz_put_huff_streams(U8 * to_ptr, U8 * const to_ptr_end, U8 * const to_end, const U8 * const from, SINTa from_len,
+									U32 huff_type, const U8 * RADRESTRICT codelens, const RR_VARBITSTYPE * RADRESTRICT le_codes,
+									rrArenaAllocator * arena)
+{
+	if ( huff_type == NEWLZ_ARRAY_TYPE_HUFF6 )
+	{
+		// 2+2+3 bytes of metadata + 6 bitstream flushes = 13 bytes overhead max
+		//	= 7 + 6 = 13
+
+		// reserve 3 bytes for size of first 3-stream complex
+		U8 * to_first3_size = to_ptr;
+		RR_ASSERT( to_end - to_first3_size >= 3 );
+		to_ptr += 3;
+
+		// put first half-stream; length needs to be >= second half-stream length
+		SINTa first_half_len = (from_len + 1)>>1;
+		SINTa size1 = newLZ_put_array_huff3streams(to_ptr,to_ptr_end,to_end,from,first_half_len,codelens,le_codes,arena);
+		RR_ASSERT( size1 > 0 );
+		to_ptr += size1;
+
+		// store size
+		U32 size24 = U32_checkA(size1);
+		RR_PUT24_LE_NOOVERRUN(to_first3_size,size24); // @@24 bits for this seems overkill, but 16 isn't guaranteed to be enough.. argh.
+
+		// put second half-stream
+		SINTa second_half_len = from_len - first_half_len;
+		SINTa size2 = newLZ_put_array_huff3streams(to_ptr,to_ptr_end,to_end,from+first_half_len,second_half_len,codelens,le_codes,arena);
+		RR_ASSERT( size2 > 0 );
+		to_ptr += size2;
+	}
+	else
+	{
+		// 2 bytes of metadata + 3 bitstream flushes = 5 bytes overhead max
+
+		SINTa size = newLZ_put_array_huff3streams(to_ptr,to_ptr_end,to_end,from,from_len,codelens,le_codes,arena);
+		RR_ASSERT( size > 0 );
+
+		to_ptr += size;
+	}
+	
+	return to_ptr;
+}
+
 SINTa newLZ_put_array_huff(U8 * const to, U8 * const to_end, const U8 * const from, SINTa from_len, 
 									const U32 * histogram, 
 									F32 lambda, const OodleSpeedFit * speedfit, F32 * pJ, F32 deadline_t,
@@ -980,26 +1051,7 @@ SINTa newLZ_put_array_huff(U8 * const to, U8 * const to_end, const U8 * const fr
 	SINTa huff_comp_len_estimate_bits = CodeLenOfHistogram256(histogram,(U32)from_len,H->codeLenTable,nonzero_alphabet);
 	F32 expected_bpb = (F32)huff_comp_len_estimate_bits / (F32)from_len;
 
-	// huff6 extra cost: (see below)
-	// - 5 extra bytes of metadata for stream sizes
-	// - 3 extra bitstream flushes at an expected 3.5 bits/stream cost
-	static const F32 HUFF6_EXTRA_BYTES = 5.0f + 3*3.5f/8.0f;
-
-	U32 huff_type = NEWLZ_ARRAY_TYPE_HUFF;
-	if ( entropy_flags & NEWLZ_ARRAY_FLAG_ALLOW_HUFF6 )
-	{
-		F32 huff6_minus_huff3_time =
-			speedfit->huff6(from_len,num_non_zero,num_alphabet_runs,expected_bpb) -
-			speedfit->huff3(from_len,num_non_zero,num_alphabet_runs,expected_bpb);
-		// huff6_minus_huff3_time is > 0 for small len , < 0 for large len
-	
-		F32 huff6_delta_J = HUFF6_EXTRA_BYTES + lambda * huff6_minus_huff3_time;
-
-		if ( huff6_delta_J < 0.0f )
-		{
-			huff_type = NEWLZ_ARRAY_TYPE_HUFF6;
-		}
-	}
+	U32 huff_type = newlz_choose_huff_type(from_len,num_non_zero,num_alphabet_runs,expected_bpb,lambda,speedfit,entropy_flags);
 	*p_huff_type = huff_type;
 	
 	F32 huff_time = speedfit_huff_time(speedfit,huff_type,from_len,num_non_zero,num_alphabet_runs,expected_bpb);
@@ -1147,41 +1199,7 @@ SINTa newLZ_put_array_huff(U8 * const to, U8 * const to_end, const U8 * const fr
 	//======================================
 	// write huffman codes to 3 (or 6) streams :
 
-	if ( huff_type == NEWLZ_ARRAY_TYPE_HUFF6 )
-	{
-		// 2+2+3 bytes of metadata + 6 bitstream flushes = 13 bytes overhead max
-		//	= 7 + 6 = 13
-
-		// reserve 3 bytes for size of first 3-stream complex
-		U8 * to_first3_size = to_ptr;
-		RR_ASSERT( to_end - to_first3_size >= 3 );
-		to_ptr += 3;
-
-		// put first half-stream; length needs to be >= second half-stream length
-		SINTa first_half_len = (from_len + 1)>>1;
-		SINTa size1 = newLZ_put_array_huff3streams(to_ptr,to_ptr_end,to_end,from,first_half_len,codelens,le_codes,arena);
-		RR_ASSERT( size1 > 0 );
-		to_ptr += size1;
-
-		// store size
-		U32 size24 = U32_checkA(size1);
-		RR_PUT24_LE_NOOVERRUN(to_first3_size,size24); // @@24 bits for this seems overkill, but 16 isn't guaranteed to be enough.. argh.
-
-		// put second half-stream
-		SINTa second_half_len = from_len - first_half_len;
-		SINTa size2 = newLZ_put_array_huff3streams(to_ptr,to_ptr_end,to_end,from+first_half_len,second_half_len,codelens,le_codes,arena);
-		RR_ASSERT( size2 > 0 );
-		to_ptr += size2;
-	}
-	else
-	{
-		// 2 bytes of metadata + 3 bitstream flushes = 5 bytes overhead max
-
-		SINTa size = newLZ_put_array_huff3streams(to_ptr,to_ptr_end,to_end,from,from_len,codelens,le_codes,arena);
-		RR_ASSERT( size > 0 );
-
-		to_ptr += size;
-	}
+	to_ptr = newlz_put_huff_streams(to_ptr,to_ptr_end,to_end,from,from_len,huff_type,codelens,le_codes,arena);
 
 	SINTa tot_comp_len = rrPtrDiff( to_ptr - to );
 
@@ -1199,14 +1217,137 @@ SINTa newLZ_put_array_huff(U8 * const to, U8 * const to_end, const U8 * const fr
 	return tot_comp_len;
 }
 
-//===================================================================
+// get the code lens (and optionally the MSB-first codes) of a built decode table
+//	symbols not in the table get len 0
+static void newlz_hufftab_get_codes(const KrakenMSBHuffTab * msbHuff, U8 * codelens, U32 * codes)
+{
+	memset(codelens,0,256);
+	
+	// each symbol fills 1<<(LIMIT-len) consecutive entries , so just step over them :
+	for (U32 i = 0; i < NEWLZ_HUFF_DECODE_TABLE_SIZE; )
+	{
+		U32 len = msbHuff->len[i];
+		U32 sym = msbHuff->sym[i];
+		RR_ASSERT( len >= 1 && len <= NEWLZ_HUFF_CODELEN_LIMIT );
+		U32 shift = NEWLZ_HUFF_CODELEN_LIMIT - len;
+		codelens[sym] = (U8)len;
+		if ( codes )
+			codes[sym] = i >> shift;
+		i += 1U << shift;
+	}
+}
 
-// Un-bit-reversed huff table in MSB-first decode order, used in building the real KrakenHuffTab
-struct KrakenMSBHuffTab
+SINTa newLZ_put_array_huff_reuse(U8 * const to, U8 * const to_end, const U8 * const from, SINTa from_len, 
+									const U32 * histogram, 
+									F32 lambda, const OodleSpeedFit * speedfit, F32 * pJ, F32 deadline_t,
+									U32 * p_huff_type, U32 entropy_flags,
+									const newlz_huff_table_cache * huff_cache,
+									rrArenaAllocator * arena)
 {
-	U8 len[NEWLZ_HUFF_DECODE_TABLE_SIZE + 16]; // code lens; +16 for sloppy memset
-	U8 sym[NEWLZ_HUFF_DECODE_TABLE_SIZE + 16]; // sym id; +16 for sloppy memset
-};
+	SIMPLEPROFILE_SCOPE_N(put_array_huff_reuse,from_len);
+	
+	RR_ASSERT( huff_cache != NULL );
+	RR_ASSERT( entropy_flags & NEWLZ_ARRAY_FLAG_ALLOW_HUFF_REUSE );
+	
+	U8 codelens[256];
+	
+	// find the cached table that codes this histogram in the fewest bits
+	//	tables that are missing a symbol we need can't be used
+	int best_slot = -1;
+	SINTa best_bits = 0;
+	for LOOP(slot,huff_cache->count)
+	{
+		newlz_hufftab_get_codes(&huff_cache->tables[slot],codelens,NULL);
+		
+		SINTa bits = 0;
+		int sym = 0;
+		for(;sym<256;sym++)
+		{
+			if ( histogram[sym] == 0 )
+				continue;
+			if ( codelens[sym] == 0 )
+				break;
+			bits += (SINTa)histogram[sym] * codelens[sym];
+		}
+		if ( sym < 256 )
+			continue;
+		
+		if ( best_slot < 0 || bits < best_bits )
+		{
+			best_slot = slot;
+			best_bits = bits;
+		}
+	}
+	
+	if ( best_slot < 0 )
+		return -1;
+	
+	F32 expected_bpb = (F32)best_bits / (F32)from_len;
+	
+	// the per-symbol term in the huff time is the code len decode & table build
+	//	which a reused table doesn't do , so pass num_non_zero = 0
+	U32 huff_type = newlz_choose_huff_type(from_len,0,0,expected_bpb,lambda,speedfit,entropy_flags);
+	
+	F32 huff_time = speedfit_huff_time(speedfit,huff_type,from_len,0,0,expected_bpb);
+	F32 huff_J_add = 5 + lambda * huff_time;
+
+	if ( huff_time > deadline_t )
+		return -1;
+	
+	// 1 byte header + same stream overhead as newLZ_put_array_huff
+	SINTa huff_comp_len_estimate = (best_bits+7)/8 + 13 + 1;
+	
+	if ( huff_comp_len_estimate + huff_J_add >= *pJ )
+	{
+		// return of -1 means we did not modify *to
+		return -1;
+	}
+	
+	// make sure we can put huff AND have 8 bytes for U64 output overwrite :
+	if ( huff_comp_len_estimate+8 >= rrPtrDiff(to_end - to) )
+	{
+		return -1;
+	}
+	
+	U32 codes[256];
+	newlz_hufftab_get_codes(&huff_cache->tables[best_slot],codelens,codes);
+	
+	RR_VARBITSTYPE le_codes[256+1];
+	for LOOP(i,256)
+	{
+		int cl = codelens[i];
+		// bit reverse as in newLZ_put_array_huff ; codes for len 0 symbols are never used
+		le_codes[i] = cl ? (newlz_huff_bitreverse(codes[i]) >> (NEWLZ_HUFF_CODELEN_LIMIT - cl)) : 0;
+	}
+	
+	U8 * to_ptr = to;
+	U8 * to_ptr_end = RR_MIN(to_end,to_ptr + from_len + 256);
+	
+	// header : "11" + slot
+	rrVarBits vb;
+	rrVarBits_PutOpen(vb.m,to_ptr);
+	rrVarBits_Puta1(vb.m);
+	rrVarBits_Puta1(vb.m);
+	rrVarBits_Put(vb.m,(U32)best_slot,2);
+	rrVarBits_PutFlush8(vb.m);
+	to_ptr += rrVarBits_PutSizeBytes(vb.m,to);
+	RR_ASSERT( to_ptr == to+1 );
+	
+	*p_huff_type = huff_type;
+	
+	to_ptr = newlz_put_huff_streams(to_ptr,to_ptr_end,to_end,from,from_len,huff_type,codelens,le_codes,arena);
+	
+	SINTa tot_comp_len = rrPtrDiff( to_ptr - to );
+	RR_ASSERT( tot_comp_len <= huff_comp_len_estimate );
+	
+	F32 huff_J = tot_comp_len + huff_J_add;
+	RR_ASSERT( huff_J <= *pJ );
+	*pJ = huff_J;
+	
+	return tot_comp_len;
+}
+
+//===================================================================
 
 #ifdef NEWLZ_X86SSE2_HUFF_ASM
 #define NEWLZ_SSE2_LAYOUT
@@ -3092,7 +3233,116 @@ static int newlz_decode_hufflens2(rrVarBits * vb, U8 * symLists, U32 * lastSymOf
 
 // ---- driver func
 
-SINTa newlz_get_array_huff(const U8 * const comp, SINTa comp_len, U8 * const to, SINTa to_len, bool is_huff6)
+/**
+
+newlz_get_hufftab : read the huff header and get the decode table
+
+returns the table to decode with, or NULL on corrupt data
+
+the table is built in msbHuff, or in the next free slot of huff_cache
+	a reused table is returned straight from huff_cache
+
+*p_num_symbols == 1 is the degenerate single symbol case
+	then *p_single_sym is filled and the returned table is not built
+
+**/
+static const KrakenMSBHuffTab * newlz_get_hufftab(rrVarBits * vb, KrakenMSBHuffTab * msbHuff,
+										newlz_huff_table_cache * huff_cache,
+										int * p_num_symbols, U8 * p_single_sym)
+{
+	rrVarBits_Temps();
+
+	U8 symListsBuf[256/*lens 1-7*/ + 256*(NEWLZ_HUFF_CODELEN_LIMIT-7) /* lens 8+*/];
+	U32 firstSymOfLen[NEWLZ_HUFF_CODELEN_LIMIT + 1];
+	U32 lastSymOfLen[NEWLZ_HUFF_CODELEN_LIMIT + 1];
+
+	// illegal codelens still need valid pointers, but it's OK for them to clash
+	// with storage for valid codelens (because if they are used, we will reject
+	// the array anyway)
+	firstSymOfLen[0] = lastSymOfLen[0] = 0;
+
+	// code lens 1..7 have at most 1<<len symbols (if code stream is valid)
+	U32 cur = 0;
+	for (U32 i = 1; i <= 7; i++)
+	{
+		firstSymOfLen[i] = lastSymOfLen[i] = cur;
+		cur += 1u << i;
+	}
+
+	// remaining lens have at most 256 symbols (if code stream is valid)
+	for (U32 i = 8; i <= NEWLZ_HUFF_CODELEN_LIMIT; i++)
+	{
+		firstSymOfLen[i] = lastSymOfLen[i] = cur;
+		cur += 256;
+	}
+
+	int gotNumSymbols;
+	
+	RR_VARBITSTYPE huff_type_flag1 = rrVarBits_Get1(vb->m);
+	if ( huff_type_flag1 )
+	{
+		RR_VARBITSTYPE huff_type_flag2 = rrVarBits_Get1(vb->m);
+	
+		//NEWLZ_ARRAY_RETURN_FAILURE();
+		//gotNumSymbols = newlz_decode_hufflens_tans(&vb,numCodesOfLen,symListsByLen);
+		// hufflens2 is on 10
+		if ( huff_type_flag2 == 0 )
+		{
+			gotNumSymbols = newlz_decode_hufflens2(vb,symListsBuf,lastSymOfLen);
+		}
+		else
+		{
+			// 11 = reuse a table from earlier in the chunk
+			U32 slot = (U32) rrVarBits_Get_C(vb->m,2);
+			if ( huff_cache == NULL || slot >= (U32)huff_cache->count )
+			{
+				rrPrintf_v2("corruption : huff_type_flag\n");
+				return NULL;
+			}
+			
+			newlz_array_get_printf("[huff reuse %d]",slot);
+			*p_num_symbols = 256; // not known, just not the degenerate case
+			return &huff_cache->tables[slot];
+		}
+	}
+	else
+	{
+		gotNumSymbols = newlz_decode_hufflens(vb,symListsBuf,lastSymOfLen);
+	}
+	
+	#ifdef SPEEDFITTING
+	g_speedfitter_huff_num_non_zero = gotNumSymbols;
+	#endif
+	
+	*p_num_symbols = gotNumSymbols;
+	
+	if (gotNumSymbols < 1) // bad stream
+		return NULL;
+	else if ( gotNumSymbols == 1 )
+	{
+		// degenerate case, no table
+		*p_single_sym = symListsBuf[0];
+		return msbHuff;
+	}
+	
+	// build in to the cache if it has room :
+	KrakenMSBHuffTab * htab = msbHuff;
+	if ( huff_cache != NULL && huff_cache->count < NEWLZ_HUFF_TABLE_CACHE_SIZE )
+		htab = &huff_cache->tables[huff_cache->count];
+	
+	// this can return failure if the code doesn't obey Kraft
+	// inequality (indicates data corruption)
+	if ( !newlz_build_msbfirst_table(firstSymOfLen, lastSymOfLen, htab, symListsBuf) )
+		return NULL;
+	
+	if ( htab != msbHuff )
+		huff_cache->count++;
+	
+	return htab;
+}
+
+SINTa newlz_get_array_huff(const U8 * const comp, SINTa comp_len, U8 * const to, SINTa to_len, bool is_huff6,
+								newlz_huff_table_cache * huff_cache)
 {
 	SIMPLEPROFILE_SCOPE_N(get_array_huff,to_len);
 	
@@ -3104,79 +3354,21 @@ SINTa newlz_get_array_huff(const U8 * const comp, SINTa comp_len, U8 * const to,
 	
 	rrVarBits vb;
 	rrVarBits_GetOpen(vb.m,comp,comp_end);
-	rrVarBits_Temps();
 	
-	{
-		U8 symListsBuf[256/*lens 1-7*/ + 256*(NEWLZ_HUFF_CODELEN_LIMIT-7) /* lens 8+*/];
-		U32 firstSymOfLen[NEWLZ_HUFF_CODELEN_LIMIT + 1];
-		U32 lastSymOfLen[NEWLZ_HUFF_CODELEN_LIMIT + 1];
-
-		// illegal codelens still need valid pointers, but it's OK for them to clash
-		// with storage for valid codelens (because if they are used, we will reject
-		// the array anyway)
-		firstSymOfLen[0] = lastSymOfLen[0] = 0;
-
-		// code lens 1..7 have at most 1<<len symbols (if code stream is valid)
-		U32 cur = 0;
-		for (U32 i = 1; i <= 7; i++)
-		{
-			firstSymOfLen[i] = lastSymOfLen[i] = cur;
-			cur += 1u << i;
-		}
-
-		// remaining lens have at most 256 symbols (if code stream is valid)
-		for (U32 i = 8; i <= NEWLZ_HUFF_CODELEN_LIMIT; i++)
-		{
-			firstSymOfLen[i] = lastSymOfLen[i] = cur;
-			cur += 256;
-		}
+	int gotNumSymbols = 0;
+	U8 single_sym = 0;
+	const KrakenMSBHuffTab * htab = newlz_get_hufftab(&vb,&msbHuff,huff_cache,&gotNumSymbols,&single_sym);
+	if ( htab == NULL )
+		NEWLZ_ARRAY_RETURN_FAILURE();
 	
-		int gotNumSymbols;
-		
-		RR_VARBITSTYPE huff_type_flag1 = rrVarBits_Get1(vb.m);
-		if ( huff_type_flag1 )
-		{
-			RR_VARBITSTYPE huff_type_flag2 = rrVarBits_Get1(vb.m);
-			huff_type_flag2;
-		
-			//NEWLZ_ARRAY_RETURN_FAILURE();
-			//gotNumSymbols = newlz_decode_hufflens_tans(&vb,numCodesOfLen,symListsByLen);
-			// hufflens2 is on 10
-			if ( huff_type_flag2 == 0 )
-			{
-				gotNumSymbols = newlz_decode_hufflens2(&vb,symListsBuf,lastSymOfLen);
-			}
-			else
-			{
-				rrPrintf_v2("corruption : huff_type_flag\n");
-				NEWLZ_ARRAY_RETURN_FAILURE();
-			}
-		}
-		else
-		{
-			gotNumSymbols = newlz_decode_hufflens(&vb,symListsBuf,lastSymOfLen);
-		}
-		
-		#ifdef SPEEDFITTING
-		g_speedfitter_huff_num_non_zero = gotNumSymbols;
-		#endif
-		
-		if (gotNumSymbols < 1) // bad stream
-			NEWLZ_ARRAY_RETURN_FAILURE();
-		else if ( gotNumSymbols == 1 )
-		{
-			// degenerate case, get done
-			//rrprintf("huff degenerate : %d\n",to_len);
-			memset(to,symListsBuf[0],to_len);
-			
-			SINTa header_size = rrVarBits_GetSizeBytes(vb.m,comp);
-			return header_size;
-		}
+	if ( gotNumSymbols == 1 )
+	{
+		// degenerate case, get done
+		//rrprintf("huff degenerate : %d\n",to_len);
+		memset(to,single_sym,to_len);
 		
-		// this can return failure if the code doesn't obey Kraft
-		// inequality (indicates data corruption)
-		if ( !newlz_build_msbfirst_table(firstSymOfLen, lastSymOfLen, &msbHuff, symListsBuf) )
-			NEWLZ_ARRAY_RETURN_FAILURE();
+		SINTa header_size = rrVarBits_GetSizeBytes(vb.m,comp);
+		return header_size;
 	}
 	
 	SINTa header_size = rrVarBits_GetSizeBytes(vb.m,comp);
@@ -3269,37 +3461,82 @@ SINTa newlz_get_array_huff(const U8 * const comp, SINTa comp_len, U8 * const to,
 	// convention: ordered from more specific to more general
 #if defined NEWLZ_JAGUAR_HUFF_ASM
 
-	return newlz_huff_jaguar(&s, &msbHuff, is_huff6) ? comp_len : -1;
+	return newlz_huff_jaguar(&s, htab, is_huff6) ? comp_len : -1;
 
 #elif defined NEWLZ_ZEN2_HUFF_ASM
 
-	return newlz_huff_zen2(&s, &msbHuff, is_huff6) ? comp_len : -1;
+	return newlz_huff_zen2(&s, htab, is_huff6) ? comp_len : -1;
 
 #elif defined NEWLZ_X64GENERIC_HUFF_ASM
 
-	return newlz_huff_x64generic(&s, &msbHuff, is_huff6) ? comp_len : -1;
+	return newlz_huff_x64generic(&s, htab, is_huff6) ? comp_len : -1;
 
 #elif defined NEWLZ_X86SSE2_HUFF_ASM
 
-	return newlz_huff_x86sse2(&s, &msbHuff, is_huff6) ? comp_len : -1;
+	return newlz_huff_x86sse2(&s, htab, is_huff6) ? comp_len : -1;
 
 #elif defined NEWLZ_ARM64
 
-	return newlz_huff64_arm(&s, &msbHuff, is_huff6) ? comp_len : -1;
+	return newlz_huff64_arm(&s, htab, is_huff6) ? comp_len : -1;
 
 #elif defined NEWLZ_ARM32
 
-	return newlz_huff32_arm(&s, &msbHuff, is_huff6) ? comp_len : -1;
+	return newlz_huff32_arm(&s, htab, is_huff6) ? comp_len : -1;
 
 #elif defined __RAD64REGS__
 
-	return newlz_huff64(&s, &msbHuff, is_huff6) ? comp_len : -1;
+	return newlz_huff64(&s, htab, is_huff6) ? comp_len : -1;
 
 #else
 
-	return newlz_huff32(&s, &msbHuff, is_huff6) ? comp_len : -1;
+	return newlz_huff32(&s, htab, is_huff6) ? comp_len : -1;
 
 #endif
 }
 
+void newlz_huff_table_cache_add_array(newlz_huff_table_cache * cache, const U8 * array_comp, const U8 * array_comp_end)
+{
+	if ( cache->count >= NEWLZ_HUFF_TABLE_CACHE_SIZE )
+		return;
+	
+	if ( rrPtrDiff(array_comp_end - array_comp) < 5 )
+		return;
+	
+	U8 first_byte = *array_comp;
+	U32 array_type = (first_byte >> 4) & 7;
+	if ( array_type != NEWLZ_ARRAY_TYPE_HUFF && array_type != NEWLZ_ARRAY_TYPE_HUFF6 )
+		return;
+	
+	// header parse as in newLZ_get_array_comp :
+	const U8 * comp_ptr = array_comp;
+	SINTa comp_len;
+	if ( first_byte >= 0x80 )
+	{
+		U32 header = RR_GET24_BE_OVERRUNOK(comp_ptr);
+		comp_ptr += 3;
+		comp_len = (SINTa)(header & NEWLZ_ARRAY_SMALL_SIZE_MASK);
+	}
+	else
+	{
+		U64 header = *comp_ptr++;
+		header <<= 32;
+		header += RR_GET32_BE_UNALIGNED(comp_ptr);
+		comp_ptr += 4;
+		comp_len = (SINTa)(header & NEWLZ_ARRAY_SIZE_MASK);
+	}
+	
+	RR_ASSERT( comp_len <= rrPtrDiff(array_comp_end - comp_ptr) );
+	
+	// read the huff header exactly as the decoder does, which adds it to the cache :
+	rrVarBits vb;
+	rrVarBits_GetOpen(vb.m,comp_ptr,comp_ptr+comp_len);
+	
+	RAD_ALIGN(KrakenMSBHuffTab, msbHuff, 16);
+	int num_symbols = 0;
+	U8 single_sym = 0;
+	const KrakenMSBHuffTab * htab = newlz_get_hufftab(&vb,&msbHuff,cache,&num_symbols,&single_sym);
+	RR_ASSERT( htab != NULL );
+	RR_UNUSED_VARIABLE(htab);
+}
+
 OODLE_NS_END
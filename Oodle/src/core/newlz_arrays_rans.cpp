@@ -0,0 +1,368 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+// This source file is licensed solely to users who have
+// accepted a valid Unreal Engine license agreement 
+// (see e.g., https://www.unrealengine.com/eula), and use
+// of this source file is governed by such agreement.
+
+#include "newlz_arrays_rans.h"
+
+#include "rrvarbits.h"
+
+#include "newlz_tans.h"
+#include "rrcompressutil.h"
+#include "histogram.h"
+#include "rrarenaallocator.h"
+#include "log2table.h"
+#include "newlz_speedfit.h"
+#include "newlz_simd.h"
+#include "newlz_arrays.inl"
+#include "lzasserts.h"
+
+//#include "rrsimpleprof.h"
+#include "rrsimpleprofstub.h"
+
+OODLE_NS_START
+
+/**
+
+newlz rANS
+
+the point of this vs TANS is to get near arithmetic coding precision
+at a decode speed that's competitive with Huff on wide SIMD machines
+
+payload :
+
+	1 bit reserved flag (0)
+	normalized counts (sum = NEWLZ_RANS_SCALE) sent with newlz_tans_PackCounts
+	flush to byte
+	32 x U32 LE initial decoder states
+	16-bit LE renorm words, read forward by the decoder
+
+encoder runs backwards over the array and writes words backwards
+decoder for symbol i : decode with state (i%32) then renorm that state
+so the words are consumed in symbol order, which is also lane order within a SIMD vector
+
+at the end of the decode, every state must be back to NEWLZ_RANS_L
+(the encoder's initial state) and every word must be consumed
+
+the counts & decode table are shared with the TANS count packer
+newlz_tans_PackCounts works for any L_bits ; we always use NEWLZ_RANS_SCALE_BITS
+
+**/
+
+RR_COMPILER_ASSERT( NEWLZ_RANS_SCALE_BITS == 12 ); // decode table packing assumes this
+
+SINTa newLZ_put_array_rans(U8 * const to, U8 * const to_end, const U8 * const from, SINTa from_len,
+									const U32 * histogram,
+									F32 lambda, const OodleSpeedFit * speedfit, F32 *pJ,
+									rrArenaAllocator * arena)
+{
+	SIMPLEPROFILE_SCOPE_N(put_array_rans,from_len);
+
+	if ( from_len < NEWLZ_RANS_ARRAY_MIN_SIZE )
+		return -1;
+
+	F32 prevJ = *pJ;
+	// we need this to be a limit against expansion :
+	RR_ASSERT( prevJ <= from_len+3 );
+
+	int alphabet = 256;
+	while ( alphabet > 0 && histogram[alphabet-1] == 0 ) alphabet--;
+	RR_ASSERT( alphabet == 256 || histogram[alphabet] == 0 );
+
+	U32 normc[256];
+	S32 num_non_zero = normalize_counts_current(normc,NEWLZ_RANS_SCALE,histogram,(int)from_len,alphabet);
+
+	if ( num_non_zero <= 1 )
+	{
+		// degenerate arrays go to RLE / memset
+		return -1;
+	}
+
+	F32 rans_J_comp_add = 5 + lambda * speedfit->rans(from_len , num_non_zero);
+	SINTa comp_len_must_be_under = (SINTa)(prevJ - rans_J_comp_add);
+	// we need this to be a limit against expansion :
+	RR_ASSERT( comp_len_must_be_under <= from_len+3 );
+
+	// can't possibly win with the state flush :
+	if ( comp_len_must_be_under <= NEWLZ_RANS_NUM_STATES*4 )
+		return -1;
+
+	memset(normc+alphabet,0,sizeof(U32)*(256 - alphabet));
+
+	// put counts :
+
+	U8 header_buf[512];
+	rrVarBits counts_vb;
+	rrVarBits_PutOpen(counts_vb.m,header_buf);
+	counts_vb.m_end = header_buf + sizeof(header_buf);
+
+	// put a 0 bit for future flagging use :
+	rrVarBits_Puta0(counts_vb.m);
+
+	newlz_tans_PackCounts(&counts_vb,NEWLZ_RANS_SCALE_BITS,normc,alphabet,num_non_zero);
+
+	rrVarBits_PutFlush8(counts_vb.m);
+	SINTa rans_header_size = rrVarBits_PutSizeBytes(counts_vb.m,header_buf);
+
+	RR_ASSERT( rans_header_size < (SINTa)sizeof(header_buf) - 32 );
+
+	// quick check to see if we're anywhere near our target
+	//	rANS codelen is very close to this, unlike TANS it's not an under-estimate by much
+	S64 H = 0;
+	for (int i = 0; i < alphabet; i++)
+	{
+		U32 c = normc[i];
+		if ( c > 0 )
+		{
+			H += (S64)histogram[i] * log2tabled<13>(c << (13 - NEWLZ_RANS_SCALE_BITS));
+		}
+	}
+	H >>= RR_LOG2TABLE_ONE_SHIFT + 3; // +3 to convert bits->bytes
+
+	SINTa fixed_size = rans_header_size + NEWLZ_RANS_NUM_STATES*4;
+
+	if ( fixed_size + H >= comp_len_must_be_under )
+	{
+		return -1;
+	}
+
+	//===============================================================
+
+	U32 cumfreq[256];
+	{
+		U32 cum = 0;
+		for(int i=0;i<alphabet;i++)
+		{
+			cumfreq[i] = cum;
+			cum += normc[i];
+		}
+		RR_ASSERT( cum == NEWLZ_RANS_SCALE );
+	}
+
+	// words are written backward from the end of word_buf
+	//	if we run off the front we can't beat comp_len_must_be_under anyway
+	SINTa word_buf_size = comp_len_must_be_under - fixed_size;
+	RR_ASSERT( word_buf_size > 0 );
+
+	RR_SCOPE_ARENA_ARRAY(word_buf,U8,word_buf_size,arena);
+
+	U8 * word_ptr = word_buf + word_buf_size;
+
+	U32 x[NEWLZ_RANS_NUM_STATES];
+	for(int i=0;i<NEWLZ_RANS_NUM_STATES;i++)
+		x[i] = NEWLZ_RANS_L;
+
+	for(SINTa i=from_len-1;i>=0;i--)
+	{
+		int sym = from[i];
+		U32 freq = normc[sym];
+		RR_ASSERT( freq > 0 && freq < NEWLZ_RANS_SCALE );
+
+		U32 & state = x[i & (NEWLZ_RANS_NUM_STATES-1)];
+
+		// renorm : after the encode x must stay < 2^32
+		//	x_max = ((L >> scale_bits) << 16) * freq
+		U32 x_max = (freq << (32 - NEWLZ_RANS_SCALE_BITS));
+		if ( state >= x_max )
+		{
+			word_ptr -= 2;
+			if ( word_ptr < word_buf )
+				return -1;
+			RR_PUT16_LE_UNALIGNED(word_ptr,(U16)state);
+			state >>= 16;
+		}
+
+		state = ((state / freq) << NEWLZ_RANS_SCALE_BITS) + (state % freq) + cumfreq[sym];
+	}
+
+	SINTa words_size = rrPtrDiff( word_buf + word_buf_size - word_ptr );
+	SINTa comp_len = fixed_size + words_size;
+
+	if ( comp_len >= comp_len_must_be_under )
+	{
+		return -1;
+	}
+
+	if ( comp_len > rrPtrDiff( to_end - to ) )
+	{
+		// not an error
+		return -1;
+	}
+
+	U8 * to_ptr = to;
+	memcpy(to_ptr,header_buf,rans_header_size);
+	to_ptr += rans_header_size;
+
+	for(int i=0;i<NEWLZ_RANS_NUM_STATES;i++)
+	{
+		RR_ASSERT( x[i] >= NEWLZ_RANS_L );
+		RR_PUT32_LE_UNALIGNED(to_ptr,x[i]);
+		to_ptr += 4;
+	}
+
+	memcpy(to_ptr,word_ptr,words_size);
+	to_ptr += words_size;
+
+	RR_ASSERT( rrPtrDiff( to_ptr - to ) == comp_len );
+
+	F32 J = comp_len + rans_J_comp_add;
+	RR_ASSERT( J < prevJ );
+	*pJ = J;
+
+	return comp_len;
+}
+
+//===============================================================================
+
+bool newlz_rans_decode_finish(KrakenRansState * s)
+{
+	SIMPLEPROFILE_SCOPE_N(rans_decode_finish,rrPtrDiff(s->decodeend - s->decodeptr));
+
+	const U32 * table = s->table;
+	U8 * decodeptr = s->decodeptr;
+	U8 * decodeend = s->decodeend;
+	const U8 * wordp = s->wordp;
+	const U8 * wordend = s->wordend;
+
+	// the SIMD kernels only do whole groups, so we always start on state 0
+	int lane = 0;
+
+	while ( decodeptr < decodeend )
+	{
+		U32 x = s->rans_state[lane];
+		U32 e = table[x & (NEWLZ_RANS_SCALE-1)];
+		*decodeptr++ = (U8)(e >> 24);
+
+		U32 hi = x >> NEWLZ_RANS_SCALE_BITS;
+		x = (e & 0xFFF) * hi + hi + ((e >> 12) & 0xFFF);
+
+		if ( x < NEWLZ_RANS_L )
+		{
+			REQUIRE_FUZZ_RETURN( 2 <= rrPtrDiff( wordend - wordp ), false );
+			x = (x << 16) | RR_GET16_LE_UNALIGNED(wordp);
+			wordp += 2;
+		}
+
+		s->rans_state[lane] = x;
+		lane = (lane + 1) & (NEWLZ_RANS_NUM_STATES-1);
+	}
+
+	s->decodeptr = decodeptr;
+	s->wordp = wordp;
+
+	return true;
+}
+
+SINTa newlz_get_array_rans(const U8 * const comp, SINTa comp_len, U8 * const to, SINTa to_len, U8 * scratch_ptr, U8 * scratch_end)
+{
+	SIMPLEPROFILE_SCOPE_N(get_array_rans,to_len);
+
+	const U8 * comp_ptr = comp;
+	const U8 * comp_end = comp + comp_len;
+
+	// always has the state flush :
+	REQUIRE_FUZZ_RETURN( comp_len >= NEWLZ_RANS_NUM_STATES*4 + 8 , -1 );
+
+	newlz_tans_UnpackedCounts unpacked_counts;
+
+	{
+	SIMPLEPROFILE_SCOPE(rans_unpack);
+
+	rrVarBits_Temps();
+	rrVarBits header_vb;
+	rrVarBits_GetOpen(header_vb.m,comp_ptr,comp_end);
+
+	RR_VARBITSTYPE flag = rrVarBits_Get1(header_vb.m);
+	// flag == 0 ; reserved for future use
+	REQUIRE_FUZZ_RETURN( flag == 0, -1 );
+
+	if ( !newlz_tans_UnPackCounts(&header_vb,NEWLZ_RANS_SCALE_BITS,&unpacked_counts) )
+	{
+		NEWLZ_ARRAY_RETURN_FAILURE();
+	}
+
+	// note comp_ptr can be after comp_end here on corrupt data :
+	comp_ptr = rrVarBits_GetEndPtr(header_vb.m);
+	}
+
+	REQUIRE_FUZZ_RETURN( NEWLZ_RANS_NUM_STATES*4 <= rrPtrDiff( comp_end - comp_ptr ), -1 );
+
+	// make the decode table in scratch :
+
+	SINTa table_size = NEWLZ_RANS_SCALE * sizeof(U32);
+	RR_COMPILER_ASSERT( NEWLZ_RANS_SCALE * sizeof(U32) + 64 < NEWLZ_ARRAY_INTERNAL_MAX_SCRATCH );
+
+	if ( (scratch_end - scratch_ptr) < 64 ) NEWLZ_ARRAY_RETURN_FAILURE();
+	scratch_ptr = rrAlignUpPointer(scratch_ptr,64);
+	if ( (scratch_end - scratch_ptr) < table_size ) NEWLZ_ARRAY_RETURN_FAILURE();
+	U32 * table = (U32 *) scratch_ptr;
+
+	{
+		SIMPLEPROFILE_SCOPE(rans_table);
+
+		U32 counts[256] = { 0 };
+		for(int i=0;i<unpacked_counts.num_singles;i++)
+			counts[ unpacked_counts.singles[i] ] = 1;
+		for(int i=0;i<unpacked_counts.num_larger;i++)
+			counts[ unpacked_counts.larger[i] >> 16 ] = unpacked_counts.larger[i] & 0xFFFF;
+
+		U32 cum = 0;
+		for(U32 sym=0;sym<256;sym++)
+		{
+			U32 freq = counts[sym];
+			if ( freq == 0 )
+				continue;
+
+			// UnPackCounts checked sum == scale ; a single symbol would have freq == scale
+			REQUIRE_FUZZ_RETURN( freq < NEWLZ_RANS_SCALE , -1 );
+
+			U32 entry = (freq-1) | (sym<<24);
+			for(U32 i=0;i<freq;i++)
+			{
+				table[cum+i] = entry + (i<<12);
+			}
+			cum += freq;
+		}
+
+		REQUIRE_FUZZ_RETURN( cum == NEWLZ_RANS_SCALE , -1 );
+	}
+
+	KrakenRansState s;
+	s.table = table;
+	s.decodeptr = to;
+	s.decodeend = to + to_len;
+
+	for(int i=0;i<NEWLZ_RANS_NUM_STATES;i++)
+	{
+		U32 x = RR_GET32_LE_UNALIGNED(comp_ptr);
+		comp_ptr += 4;
+		REQUIRE_FUZZ_RETURN( x >= NEWLZ_RANS_L , -1 );
+		s.rans_state[i] = x;
+	}
+
+	s.wordp = comp_ptr;
+	s.wordend = comp_end;
+
+	#ifdef DO_BUILD_AVX2
+	if ( newlz_simd_has_avx2_bulk() )
+	{
+		if ( ! newlz_rans_decode_avx2(&s) )
+			NEWLZ_ARRAY_RETURN_FAILURE();
+	}
+	#endif
+
+	if ( ! newlz_rans_decode_finish(&s) )
+		NEWLZ_ARRAY_RETURN_FAILURE();
+
+	// all words consumed and all states back to the encoder's initial state :
+	REQUIRE_FUZZ_RETURN( s.wordp == s.wordend , -1 );
+	for(int i=0;i<NEWLZ_RANS_NUM_STATES;i++)
+	{
+		REQUIRE_FUZZ_RETURN( s.rans_state[i] == NEWLZ_RANS_L , -1 );
+	}
+
+	return comp_len;
+}
+
+OODLE_NS_END
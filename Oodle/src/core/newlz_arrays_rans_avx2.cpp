@@ -0,0 +1,180 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+// This source file is licensed solely to users who have
+// accepted a valid Unreal Engine license agreement 
+// (see e.g., https://www.unrealengine.com/eula), and use
+// of this source file is governed by such agreement.
+
+// @cdep pre $cbtargetavx2
+#include "newlz_arrays_rans.h"
+#include "newlz_simd.h"
+
+//#include "rrsimpleprof.h"
+#include "rrsimpleprofstub.h"
+
+OODLE_NS_START
+
+#ifdef DO_BUILD_AVX2
+
+OODLE_NS_END
+#include <immintrin.h>
+OODLE_NS_START
+
+/**
+
+AVX2 rANS decoder, 8 states per vector, 4 vectors per group of 32 symbols
+
+the renorm words for a vector are consumed in lane order, so we load the next 8 words
+and compact them into the lanes that need them with a permute from c_rans_renorm_shuf
+
+**/
+
+// for each 8-bit lane mask, byte i = index of lane i's word among the set lanes
+static const RAD_ALIGN(U64, c_rans_renorm_shuf[256], 64) =
+{
+	0x0000000000000000ULL, 0x0000000000000000ULL, 0x0000000000000000ULL, 0x0000000000000100ULL,
+	0x0000000000000000ULL, 0x0000000000010000ULL, 0x0000000000010000ULL, 0x0000000000020100ULL,
+	0x0000000000000000ULL, 0x0000000001000000ULL, 0x0000000001000000ULL, 0x0000000002000100ULL,
+	0x0000000001000000ULL, 0x0000000002010000ULL, 0x0000000002010000ULL, 0x0000000003020100ULL,
+	0x0000000000000000ULL, 0x0000000100000000ULL, 0x0000000100000000ULL, 0x0000000200000100ULL,
+	0x0000000100000000ULL, 0x0000000200010000ULL, 0x0000000200010000ULL, 0x0000000300020100ULL,
+	0x0000000100000000ULL, 0x0000000201000000ULL, 0x0000000201000000ULL, 0x0000000302000100ULL,
+	0x0000000201000000ULL, 0x0000000302010000ULL, 0x0000000302010000ULL, 0x0000000403020100ULL,
+	0x0000000000000000ULL, 0x0000010000000000ULL, 0x0000010000000000ULL, 0x0000020000000100ULL,
+	0x0000010000000000ULL, 0x0000020000010000ULL, 0x0000020000010000ULL, 0x0000030000020100ULL,
+	0x0000010000000000ULL, 0x0000020001000000ULL, 0x0000020001000000ULL, 0x0000030002000100ULL,
+	0x0000020001000000ULL, 0x0000030002010000ULL, 0x0000030002010000ULL, 0x0000040003020100ULL,
+	0x0000010000000000ULL, 0x0000020100000000ULL, 0x0000020100000000ULL, 0x0000030200000100ULL,
+	0x0000020100000000ULL, 0x0000030200010000ULL, 0x0000030200010000ULL, 0x0000040300020100ULL,
+	0x0000020100000000ULL, 0x0000030201000000ULL, 0x0000030201000000ULL, 0x0000040302000100ULL,
+	0x0000030201000000ULL, 0x0000040302010000ULL, 0x0000040302010000ULL, 0x0000050403020100ULL,
+	0x0000000000000000ULL, 0x0001000000000000ULL, 0x0001000000000000ULL, 0x0002000000000100ULL,
+	0x0001000000000000ULL, 0x0002000000010000ULL, 0x0002000000010000ULL, 0x0003000000020100ULL,
+	0x0001000000000000ULL, 0x0002000001000000ULL, 0x0002000001000000ULL, 0x0003000002000100ULL,
+	0x0002000001000000ULL, 0x0003000002010000ULL, 0x0003000002010000ULL, 0x0004000003020100ULL,
+	0x0001000000000000ULL, 0x0002000100000000ULL, 0x0002000100000000ULL, 0x0003000200000100ULL,
+	0x0002000100000000ULL, 0x0003000200010000ULL, 0x0003000200010000ULL, 0x0004000300020100ULL,
+	0x0002000100000000ULL, 0x0003000201000000ULL, 0x0003000201000000ULL, 0x0004000302000100ULL,
+	0x0003000201000000ULL, 0x0004000302010000ULL, 0x0004000302010000ULL, 0x0005000403020100ULL,
+	0x0001000000000000ULL, 0x0002010000000000ULL, 0x0002010000000000ULL, 0x0003020000000100ULL,
+	0x0002010000000000ULL, 0x0003020000010000ULL, 0x0003020000010000ULL, 0x0004030000020100ULL,
+	0x0002010000000000ULL, 0x0003020001000000ULL, 0x0003020001000000ULL, 0x0004030002000100ULL,
+	0x0003020001000000ULL, 0x0004030002010000ULL, 0x0004030002010000ULL, 0x0005040003020100ULL,
+	0x0002010000000000ULL, 0x0003020100000000ULL, 0x0003020100000000ULL, 0x0004030200000100ULL,
+	0x0003020100000000ULL, 0x0004030200010000ULL, 0x0004030200010000ULL, 0x0005040300020100ULL,
+	0x0003020100000000ULL, 0x0004030201000000ULL, 0x0004030201000000ULL, 0x0005040302000100ULL,
+	0x0004030201000000ULL, 0x0005040302010000ULL, 0x0005040302010000ULL, 0x0006050403020100ULL,
+	0x0000000000000000ULL, 0x0100000000000000ULL, 0x0100000000000000ULL, 0x0200000000000100ULL,
+	0x0100000000000000ULL, 0x0200000000010000ULL, 0x0200000000010000ULL, 0x0300000000020100ULL,
+	0x0100000000000000ULL, 0x0200000001000000ULL, 0x0200000001000000ULL, 0x0300000002000100ULL,
+	0x0200000001000000ULL, 0x0300000002010000ULL, 0x0300000002010000ULL, 0x0400000003020100ULL,
+	0x0100000000000000ULL, 0x0200000100000000ULL, 0x0200000100000000ULL, 0x0300000200000100ULL,
+	0x0200000100000000ULL, 0x0300000200010000ULL, 0x0300000200010000ULL, 0x0400000300020100ULL,
+	0x0200000100000000ULL, 0x0300000201000000ULL, 0x0300000201000000ULL, 0x0400000302000100ULL,
+	0x0300000201000000ULL, 0x0400000302010000ULL, 0x0400000302010000ULL, 0x0500000403020100ULL,
+	0x0100000000000000ULL, 0x0200010000000000ULL, 0x0200010000000000ULL, 0x0300020000000100ULL,
+	0x0200010000000000ULL, 0x0300020000010000ULL, 0x0300020000010000ULL, 0x0400030000020100ULL,
+	0x0200010000000000ULL, 0x0300020001000000ULL, 0x0300020001000000ULL, 0x0400030002000100ULL,
+	0x0300020001000000ULL, 0x0400030002010000ULL, 0x0400030002010000ULL, 0x0500040003020100ULL,
+	0x0200010000000000ULL, 0x0300020100000000ULL, 0x0300020100000000ULL, 0x0400030200000100ULL,
+	0x0300020100000000ULL, 0x0400030200010000ULL, 0x0400030200010000ULL, 0x0500040300020100ULL,
+	0x0300020100000000ULL, 0x0400030201000000ULL, 0x0400030201000000ULL, 0x0500040302000100ULL,
+	0x0400030201000000ULL, 0x0500040302010000ULL, 0x0500040302010000ULL, 0x0600050403020100ULL,
+	0x0100000000000000ULL, 0x0201000000000000ULL, 0x0201000000000000ULL, 0x0302000000000100ULL,
+	0x0201000000000000ULL, 0x0302000000010000ULL, 0x0302000000010000ULL, 0x0403000000020100ULL,
+	0x0201000000000000ULL, 0x0302000001000000ULL, 0x0302000001000000ULL, 0x0403000002000100ULL,
+	0x0302000001000000ULL, 0x0403000002010000ULL, 0x0403000002010000ULL, 0x0504000003020100ULL,
+	0x0201000000000000ULL, 0x0302000100000000ULL, 0x0302000100000000ULL, 0x0403000200000100ULL,
+	0x0302000100000000ULL, 0x0403000200010000ULL, 0x0403000200010000ULL, 0x0504000300020100ULL,
+	0x0302000100000000ULL, 0x0403000201000000ULL, 0x0403000201000000ULL, 0x0504000302000100ULL,
+	0x0403000201000000ULL, 0x0504000302010000ULL, 0x0504000302010000ULL, 0x0605000403020100ULL,
+	0x0201000000000000ULL, 0x0302010000000000ULL, 0x0302010000000000ULL, 0x0403020000000100ULL,
+	0x0302010000000000ULL, 0x0403020000010000ULL, 0x0403020000010000ULL, 0x0504030000020100ULL,
+	0x0302010000000000ULL, 0x0403020001000000ULL, 0x0403020001000000ULL, 0x0504030002000100ULL,
+	0x0403020001000000ULL, 0x0504030002010000ULL, 0x0504030002010000ULL, 0x0605040003020100ULL,
+	0x0302010000000000ULL, 0x0403020100000000ULL, 0x0403020100000000ULL, 0x0504030200000100ULL,
+	0x0403020100000000ULL, 0x0504030200010000ULL, 0x0504030200010000ULL, 0x0605040300020100ULL,
+	0x0403020100000000ULL, 0x0504030201000000ULL, 0x0504030201000000ULL, 0x0605040302000100ULL,
+	0x0504030201000000ULL, 0x0605040302010000ULL, 0x0605040302010000ULL, 0x0706050403020100ULL,
+};
+
+static RADFORCEINLINE __m256i rans_avx2_decode_vec(__m256i & x, const U32 * table, const U8 * & wordp)
+{
+	const __m256i mask12 = _mm256_set1_epi32(NEWLZ_RANS_SCALE-1);
+
+	__m256i slot = _mm256_and_si256(x, mask12);
+	__m256i e = _mm256_i32gather_epi32((const int *)table, slot, 4);
+	__m256i hi = _mm256_srli_epi32(x, NEWLZ_RANS_SCALE_BITS);
+
+	// x = freq * (x>>12) + (x&4095) - cumfreq
+	__m256i freqm1 = _mm256_and_si256(e, mask12);
+	__m256i bias = _mm256_and_si256(_mm256_srli_epi32(e, 12), mask12);
+	x = _mm256_add_epi32(_mm256_add_epi32(_mm256_mullo_epi32(hi, freqm1), hi), bias);
+
+	// renorm lanes with x < L :
+	__m256i need = _mm256_cmpeq_epi32(_mm256_srli_epi32(x, 16), _mm256_setzero_si256());
+	U32 mask = (U32) _mm256_movemask_ps(_mm256_castsi256_ps(need));
+
+	__m256i words = _mm256_cvtepu16_epi32(_mm_loadu_si128((const __m128i *)wordp));
+	__m256i shuf = _mm256_cvtepu8_epi32(_mm_loadl_epi64((const __m128i *)(c_rans_renorm_shuf + mask)));
+	words = _mm256_permutevar8x32_epi32(words, shuf);
+
+	__m256i renormed = _mm256_or_si256(_mm256_slli_epi32(x, 16), words);
+	x = _mm256_blendv_epi8(x, renormed, need);
+
+	wordp += 2 * _mm_popcnt_u32(mask);
+
+	return _mm256_srli_epi32(e, 24);
+}
+
+bool newlz_rans_decode_avx2(KrakenRansState * s)
+{
+	SIMPLEPROFILE_SCOPE_N(rans_decode_avx2,rrPtrDiff(s->decodeend - s->decodeptr));
+
+	const U32 * table = s->table;
+	U8 * decodeptr = s->decodeptr;
+	U8 * decodeend = s->decodeend;
+	const U8 * wordp = s->wordp;
+	const U8 * wordend = s->wordend;
+
+	__m256i x0 = _mm256_loadu_si256((const __m256i *)(s->rans_state + 0));
+	__m256i x1 = _mm256_loadu_si256((const __m256i *)(s->rans_state + 8));
+	__m256i x2 = _mm256_loadu_si256((const __m256i *)(s->rans_state + 16));
+	__m256i x3 = _mm256_loadu_si256((const __m256i *)(s->rans_state + 24));
+
+	const __m256i pack_perm = _mm256_setr_epi32(0,4,1,5,2,6,3,7);
+
+	// a group consumes at most 64 bytes of words, and the last vector reads 16 bytes
+	//	from at most 56 bytes in, so 80 bytes of slop keeps every load in bounds
+	//	the scalar decoder does the tail with exact checks
+	while ( rrPtrDiff(decodeend - decodeptr) >= NEWLZ_RANS_NUM_STATES &&
+			rrPtrDiff(wordend - wordp) >= 80 )
+	{
+		__m256i s0 = rans_avx2_decode_vec(x0, table, wordp);
+		__m256i s1 = rans_avx2_decode_vec(x1, table, wordp);
+		__m256i s2 = rans_avx2_decode_vec(x2, table, wordp);
+		__m256i s3 = rans_avx2_decode_vec(x3, table, wordp);
+
+		// syms are < 256 so the saturating packs are exact
+		__m256i s01 = _mm256_packus_epi32(s0, s1);
+		__m256i s23 = _mm256_packus_epi32(s2, s3);
+		__m256i syms = _mm256_packus_epi16(s01, s23);
+		syms = _mm256_permutevar8x32_epi32(syms, pack_perm);
+
+		_mm256_storeu_si256((__m256i *)decodeptr, syms);
+		decodeptr += NEWLZ_RANS_NUM_STATES;
+	}
+
+	_mm256_storeu_si256((__m256i *)(s->rans_state + 0), x0);
+	_mm256_storeu_si256((__m256i *)(s->rans_state + 8), x1);
+	_mm256_storeu_si256((__m256i *)(s->rans_state + 16), x2);
+	_mm256_storeu_si256((__m256i *)(s->rans_state + 24), x3);
+
+	s->decodeptr = decodeptr;
+	s->wordp = wordp;
+
+	return true;
+}
+
+#endif // DO_BUILD_AVX2
+
+OODLE_NS_END
@@ -81,9 +81,15 @@ static Vec128 splatb_128(const U8 *p)		{ return _mm_set1_epi8(*p); }
 static Vec128 read128(const U8 *p)			{ return _mm_loadu_si128((const __m128i *)p); }
 static void write128(U8 *dst, Vec128 v)		{ _mm_storeu_si128((__m128i *)dst, v); }
 static void write128a(U8 *dst, Vec128 v)	{ _mm_store_si128((__m128i *)dst, v); }
+static U8 firstb_128(Vec128 v)				{ return (U8)_mm_cvtsi128_si32(v); }
 
 #define HAVE_SIMD_RLE7_SEARCHES
 
+#ifdef DO_BUILD_AVX2
+// long RL / long LRL escapes in newlz_rle_escape_packet.inl can go to the AVX2 kernels
+#define RLE7_AVX2_BULK_DECODE
+#endif
+
 // skip ahead to next run of 3+ identical bytes
 static RADFORCEINLINE const U8 *rle7_skip_to_next_run3(const U8 *in_ptr, const U8 *in_safe_end)
 {
@@ -295,114 +301,22 @@ static RADFORCEINLINE const U8 *rle7_find_run_end(const U8 *run_ptr, const U8 *i
 
 #endif
 
-// Emits one or two simple packets. You need to check whether that fits before you call!
-static RADFORCEINLINE U8 *rle7_emit_short_packets(U8 *pktp, U8 *litp, UINTa lrl, UINTa rl)
+// memcpy(litp, lit_start, lrl) but sloppy ; always copies at least 16 bytes
+static RADFORCEINLINE void rle7_copy_literals_sloppy(U8 *litp, const U8 *lit_start, UINTa lrl)
 {
-	RR_ASSERT(pktp - litp >= 2); // this function will emit at most 2 bytes.
-	RR_ASSERT(rl >= 3);
-	(void)litp; // shut up warnings
-
-	if (lrl <= 15)
-	{
-		if (rl <= 15)
-			*--pktp = static_cast<U8>((rl << 4) | (15 - lrl));
-		else
-		{
-			RR_ASSERT(rl <= 30);
-
-			// Neither packet may have a run length below 3, so just split the run in half.
-			UINTa lo_rl = rl >> 1;
-			UINTa hi_rl = rl - lo_rl;
-
-			*--pktp = static_cast<U8>((lo_rl << 4) | (15 - lrl));
-			*--pktp = static_cast<U8>((hi_rl << 4) | 15);
-		}
-	}
-	else
+	U8 *litp_end = litp + lrl;
+	do
 	{
-		RR_ASSERT(lrl <= 30 && rl <= 15);
-		*--pktp = 0x00; // rl=0, lrl=15
-		*--pktp = static_cast<U8>((rl << 4) | (15 - (lrl - 15)));
+		write128(litp, read128(lit_start));
+		litp += 16;
+		lit_start += 16;
 	}
-
-	return pktp;
+	while (litp < litp_end);
 }
 
-// Returns NULL if we run out of output space.
-static RADFORCEINLINE U8 *rle7_emit_long_packet(U8 *pktp, U8 *litp, UINTa lrl, UINTa rl)
-{
-	// Required safety margin for the common cases, long LRL/RL can check every iter (they're rare)
-	static const SINTa kMiddleMaxBytes = 2; // max bytes for middle part (medium packet)
-	RR_ASSERT(pktp - litp >= 1 + kMiddleMaxBytes); // simple packet in front (next if)
-
-	// If we're just slightly above 63, it's better to use a simple packet to get us below than to send a long LRL packet
-	if (lrl >= 64 && lrl < 79)
-	{
-		// NOTE this packet priced into safety margin above
-		*--pktp = 0x00; // rl=0, lrl=15
-		lrl -= 15;
-	}
-
-	// long LRL
-	while (lrl >= 64)
-	{
-		static const UINTa kMaxValLRL = 7*256;
-		U32 lrl_this_run = static_cast<U32>(RR_MIN(lrl >> 6, kMaxValLRL));
-		RR_ASSERT(lrl_this_run >= 1);
-
-		// long LRL not priced into safety margin above, need to check whether this packet puts us below
-		// the required number of bytes for the middle packet.
-		if (pktp - litp < kMiddleMaxBytes + 2)
-			return NULL;
-
-		U32 v = lrl_this_run - 1;
-		*--pktp = static_cast<U8>(2 + (v >> 8));
-		*--pktp = (U8)v; // & 0xff;
-
-		lrl -= lrl_this_run << 6;
-	}
-
-	// Middle part
-	RR_ASSERT(pktp - litp >= kMiddleMaxBytes);
-	UINTa rl_rem = rl & 0x7f;
-	if (rl_rem < 3 || lrl > 30 || (rl_rem > 15 && lrl > 15) || rl_rem > 30) // NOTE(fg): more than two simple packets for the remainder
-	//if (rl_rem < 3 || lrl > 15 || rl_rem > 15) // NOTE(fg): more than one simple packet for the remainder
-	{
-		// Don't emit middle packet if LRL and RL are both 0!
-		// This is an optimization but it's important when a stream ends with a multiple of 64 literals;
-		// the extra lrl=0 rl=0 medium-length packet occurs after all bytes have been decoded, which is
-		// not allowed.
-		if ((lrl | rl_rem) != 0)
-		{
-			// medium packet
-			U32 v = static_cast<U32>(lrl | (rl_rem << 6));
-			*--pktp = static_cast<U8>((v >> 8) + 0x10);
-			*--pktp = (U8)v; // & 0xff;
-		}
-	}
-	else
-		pktp = rle7_emit_short_packets(pktp, litp, lrl, rl_rem);
-
-	// Long RL
-	while (rl >= 128)
-	{
-		static const UINTa kMaxValRL = 7*256;
-		U32 rl_this_run = static_cast<U32>(RR_MIN(rl >> 7, kMaxValRL));
-		RR_ASSERT(rl_this_run >= 1);
-
-		// Long RL not considered in safety margin, need to check on every packet (but that's fine)
-		if (pktp - litp < 2)
-			return NULL;
-
-		U32 v = rl_this_run - 1;
-		*--pktp = static_cast<U8>(9 + (v >> 8));
-		*--pktp = (U8)v; // & 0xff;
-
-		rl -= rl_this_run << 7;
-	}
-
-	return pktp;
-}
+#define RLE7_PARSE_NAME		rle7_parse
+#define RLE7_PARSE_LINKAGE	static
+#include "newlz_arrays_rle_encode.inl"
 
 // Returns value >in_size if encode fails (not enough output space)
 SINTa newLZ_put_array_rle(U8 * const out_buf, U8 * const out_end, const U8 *in_buf, SINTa in_len_signed, 
@@ -410,9 +324,6 @@ SINTa newLZ_put_array_rle(U8 * const out_buf, U8 * const out_end, const U8 *in_b
 {
 	SIMPLEPROFILE_SCOPE_N(put_array_rle,in_len_signed);
 	
-	// Min run len for us to consider sending a new run value
-	static const UINTa RLE7_MRL_NEWV = 8;
-
 	// Run length detection safety margin
 	static const UINTa kRunSafetyMargin = 16 + 2; // 16-byte SSE2 loads; we load ptr, ptr+1, ptr+2 to identify 3-byte runs.
 
@@ -426,7 +337,6 @@ SINTa newLZ_put_array_rle(U8 * const out_buf, U8 * const out_end, const U8 *in_b
 	U8 *litp = out_buf;
 	U8 *pktp = out_end;
 
-	const U8 *in_ptr = in_buf;
 	const U8 *lit_start = in_buf;
 	const U8 *in_safe_end = in_buf + subtract_sat(in_size, kRunSafetyMargin); // for SSE2 len-3-run detection
 	const U8 *in_end = in_buf + in_size;
@@ -435,81 +345,16 @@ SINTa newLZ_put_array_rle(U8 * const out_buf, U8 * const out_end, const U8 *in_b
 	*litp++ = 0; // "uncompressed" header flag (note we checked earlier that out_end - out_buf >= 5, so we're good here)
 	U8 *first_lit = litp; // first real literal
 
-	while (in_ptr < in_safe_end)
-	{
-		// Skip over run-less regions quickly
-		in_ptr = rle7_skip_to_next_run3(in_ptr, in_safe_end);
-
-		// Don't even bother trying to find runs starting within the last few bytes of
-		// the input buffer; the benefit is small and not having to deal with it makes
-		// writing a fast encoder simpler.
-		if (in_ptr >= in_safe_end)
-			break;
-
-		// Determine run length starting at current byte.
-		// This returns the end of the run.
-		const U8 *run_end = rle7_find_run_end(in_ptr, in_safe_end, in_end);
-
-		// If long enough run, emit it!
-		U8 v = *in_ptr;
-		UINTa lrl = in_ptr - lit_start;
-		UINTa run_len = run_end - in_ptr;
-		in_ptr = run_end; // advance ptr whether we send the run or not
-
-		// We started by skipping ahead to the next len-3 run, so this run better be
-		// at least 3 bytes.
-		RR_ASSERT(run_len >= 3);
-
-		// We check for a little more output space than required. This allows us to do the
-		// literal copying sloppily, but it also accounts for the number of packet bytes we
-		// need to send later (see checks in emit_short_packets and emit_long_packet).
-		static const UINTa kSafetyMargin = 2 + 16; // 2 bytes for "change run value" packet, up to 16 slop for copy. (Which also guarantees min packet space.)
-		UINTa bytes_left = pktp - litp;
-		if (bytes_left < lrl + kSafetyMargin)
-			return in_len_signed + 1;
-
-		// If we change run value, make sure our run is long enough, and send the
-		// "change run value" packet.
-		if (v != last_v)
-		{
-			if (run_len < RLE7_MRL_NEWV)
-				continue;
-			*--pktp = 1; // "new run symbol" code
-			*litp++ = v;
-			last_v = v;
-		}
-
-		// Copy literals over
-		// NOTE kSafetyMargin above guarantees we can do this sloppily, as long
-		// as we're far away enough from the end of the input, which our in_ptr < in_safe_end
-		// checks above guarantee.
-		//
-		// Slop here is 16 not 15 because we can have lrl=0 (after changing run value)
-		// but we always copy at least 16 bytes.
-		RR_ASSERT(in_end - (lit_start + lrl) >= 16);
-
-		// memcpy(litp, lit_start, lrl); litp += lrl; // but sloppy
-		U8 *litp_end = litp + lrl;
-		do
-		{
-			write128(litp, read128(lit_start));
-			litp += 16;
-			lit_start += 16;
-		}
-		while (litp < litp_end);
-		litp = litp_end;
-		lit_start = in_ptr;
+	bool parse_ok;
+	#if defined(__RADSSE2__) && defined(DO_BUILD_AVX2)
+	if ( newlz_simd_has_avx2_bulk() )
+		parse_ok = newLZ_rle7_parse_avx2(in_safe_end, in_end, &lit_start, &litp, &pktp, &last_v);
+	else
+	#endif
+		parse_ok = rle7_parse(in_safe_end, in_end, &lit_start, &litp, &pktp, &last_v);
 
-		if (lrl > 30 || (run_len > 15 && lrl > 15) || run_len > 30) // NOTE(fg): more than two simple packets
-		//if (run_len > 15 || lrl > 15) // NOTE(fg): more than one simple packet
-		{
-			pktp = rle7_emit_long_packet(pktp, litp, lrl, run_len);
-			if (!pktp) // ran out of output space
-				return in_len_signed + 1;
-		}
-		else
-			pktp = rle7_emit_short_packets(pktp, litp, lrl, run_len);
-	}
+	if ( ! parse_ok ) // ran out of output space
+		return in_len_signed + 1;
 
 	if (UINTa lrl = in_end - lit_start)
 	{
@@ -739,6 +584,9 @@ SINTa newLZ_get_array_rle(const U8 * const comp, SINTa comp_len, U8 * const to,
 	U8 *out_check = outp + subtract_sat(to_len, kMaxWriteFastCheck-1);
 	U8 *out_end = outp + to_len;
 	Vec128 runv = splatz_128();
+	#ifdef RLE7_AVX2_BULK_DECODE
+	const bool use_avx2 = newlz_simd_has_avx2_bulk() != 0;
+	#endif
 
 	#define RLE7_SIMPLE_PACKET(packet) \
 		{ \
@@ -0,0 +1,180 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+// This source file is licensed solely to users who have
+// accepted a valid Unreal Engine license agreement 
+// (see e.g., https://www.unrealengine.com/eula), and use
+// of this source file is governed by such agreement.
+
+// @cdep pre $cbtargetavx2
+#include "newlz_arrays_rle.h"
+#include "rrbits.h"
+#include "rrmem.h"
+#include "newlz_simd.h"
+
+OODLE_NS_START
+
+#ifdef DO_BUILD_AVX2
+
+OODLE_NS_END
+#include <immintrin.h>
+OODLE_NS_START
+
+/**
+
+AVX2 versions of the RLE7 run searches and bulk copies
+
+the 32-wide searches run only while there are enough bytes to the end of the buffer ;
+near the end they drop to the same 16-wide loops as the SSE2 path,
+so the encoder finds exactly the same runs and the output is unchanged
+
+**/
+
+// ---- Encoder
+
+// skip ahead to next run of 3+ identical bytes
+static RADFORCEINLINE const U8 *rle7_skip_to_next_run3(const U8 *in_ptr, const U8 *in_safe_end)
+{
+	RR_ASSERT(in_ptr < in_safe_end);
+
+	// in_safe_end is 18 back from in_end ; 32 wide reads [in_ptr,in_ptr+34)
+	while ( in_safe_end - in_ptr >= 16 )
+	{
+		__m256i bytes0 = _mm256_loadu_si256((const __m256i *)(in_ptr));
+		__m256i bytes1 = _mm256_loadu_si256((const __m256i *)(in_ptr + 1));
+		__m256i bytes2 = _mm256_loadu_si256((const __m256i *)(in_ptr + 2));
+		__m256i bytes_run3 = _mm256_and_si256(_mm256_cmpeq_epi8(bytes1, bytes0), _mm256_cmpeq_epi8(bytes2, bytes0));
+		U32 mask = (U32) _mm256_movemask_epi8(bytes_run3);
+		if (mask != 0)
+			return in_ptr + rrCtz32(mask);
+
+		in_ptr += 32;
+	}
+
+	while (in_ptr < in_safe_end)
+	{
+		__m128i bytes0 = _mm_loadu_si128((const __m128i *)(in_ptr));
+		__m128i bytes1 = _mm_loadu_si128((const __m128i *)(in_ptr + 1));
+		__m128i bytes2 = _mm_loadu_si128((const __m128i *)(in_ptr + 2));
+		__m128i bytes_run3 = _mm_and_si128(_mm_cmpeq_epi8(bytes1, bytes0), _mm_cmpeq_epi8(bytes2, bytes0));
+		int mask = _mm_movemask_epi8(bytes_run3);
+		if (mask != 0)
+			return in_ptr + rrCtz32(mask);
+
+		in_ptr += 16;
+	}
+
+	return in_ptr;
+}
+
+// determine end of run starting at run_ptr ; exact
+static RADFORCEINLINE const U8 *rle7_find_run_end(const U8 *run_ptr, const U8 *in_safe_end, const U8 *in_end)
+{
+	RR_ASSERT(run_ptr < in_safe_end);
+	RR_ASSERT( (in_end - in_safe_end) >= 18 );
+
+	U64 first = RR_GET64_NATIVE_UNALIGNED(run_ptr);
+	U64 diff = RR_GET64_NATIVE_UNALIGNED(run_ptr + 1) ^ first;
+	if (diff)
+		return run_ptr + 1 + rrCtzBytes64(diff);
+
+	// [run_ptr,run_ptr+9) are all the same byte
+	U8 v = (U8)first; // & 0xff;
+	run_ptr += 9;
+
+	__m256i bytes_first = _mm256_set1_epi8((char)v);
+	while ( in_end - run_ptr >= 32 )
+	{
+		__m256i bytes = _mm256_loadu_si256((const __m256i *)run_ptr);
+		U32 mask = (U32) _mm256_movemask_epi8(_mm256_cmpeq_epi8(bytes, bytes_first));
+		if (mask != 0xffffffffU)
+			return run_ptr + rrCtz32(~mask);
+		run_ptr += 32;
+	}
+
+	if ( in_end - run_ptr >= 16 )
+	{
+		__m128i bytes = _mm_loadu_si128((const __m128i *)run_ptr);
+		U32 mask = (U32) _mm_movemask_epi8(_mm_cmpeq_epi8(bytes, _mm256_castsi256_si128(bytes_first)));
+		if (mask != 0xffff)
+			return run_ptr + rrCtz32(~mask);
+		run_ptr += 16;
+	}
+
+	while (run_ptr < in_end && *run_ptr == v)
+		++run_ptr;
+	return run_ptr;
+}
+
+// memcpy(litp, lit_start, lrl) but sloppy ; same 16 byte slop as the SSE2 version
+static RADFORCEINLINE void rle7_copy_literals_sloppy(U8 *litp, const U8 *lit_start, UINTa lrl)
+{
+	U8 *litp_end = litp + lrl;
+	while ( litp_end - litp >= 32 )
+	{
+		_mm256_storeu_si256((__m256i *)litp, _mm256_loadu_si256((const __m256i *)lit_start));
+		litp += 32;
+		lit_start += 32;
+	}
+	do
+	{
+		_mm_storeu_si128((__m128i *)litp, _mm_loadu_si128((const __m128i *)lit_start));
+		litp += 16;
+		lit_start += 16;
+	}
+	while (litp < litp_end);
+}
+
+#define RLE7_PARSE_NAME		newLZ_rle7_parse_avx2
+#include "newlz_arrays_rle_encode.inl"
+
+// ---- Decoder
+
+void newLZ_rle7_fill_run_avx2(U8 * to, U8 run_val, SINTa len)
+{
+	RR_ASSERT( len >= 128 );
+	__m256i runv = _mm256_set1_epi8((char)run_val);
+
+	// first 32 bytes and last 128 bytes unaligned
+	_mm256_storeu_si256((__m256i *)to, runv);
+	U8 * to_end = to + len;
+	_mm256_storeu_si256((__m256i *)(to_end - 0x80), runv);
+	_mm256_storeu_si256((__m256i *)(to_end - 0x60), runv);
+	_mm256_storeu_si256((__m256i *)(to_end - 0x40), runv);
+	_mm256_storeu_si256((__m256i *)(to_end - 0x20), runv);
+
+	// rest aligned
+	U8 * to_a = (U8 *)(((UINTa)to + 32) & ~(UINTa)31);
+	U8 * to_a_end = to_end - 0x80;
+	while ( to_a < to_a_end )
+	{
+		_mm256_store_si256((__m256i *)(to_a + 0x00), runv);
+		_mm256_store_si256((__m256i *)(to_a + 0x20), runv);
+		_mm256_store_si256((__m256i *)(to_a + 0x40), runv);
+		_mm256_store_si256((__m256i *)(to_a + 0x60), runv);
+		to_a += 0x80;
+	}
+}
+
+void newLZ_rle7_copy_lits_avx2(U8 * to, const U8 * from, SINTa len)
+{
+	RR_ASSERT( len >= 64 );
+
+	// first and last 32 bytes unaligned
+	_mm256_storeu_si256((__m256i *)to, _mm256_loadu_si256((const __m256i *)from));
+	_mm256_storeu_si256((__m256i *)(to + len - 32), _mm256_loadu_si256((const __m256i *)(from + len - 32)));
+
+	// rest with aligned stores
+	UINTa align_amt = 32 - ((UINTa)to & 31);
+	U8 * to_a = to + align_amt;
+	const U8 * from_a = from + align_amt;
+	U8 * to_a_end = to + len - 32;
+	while ( to_a < to_a_end )
+	{
+		_mm256_store_si256((__m256i *)to_a, _mm256_loadu_si256((const __m256i *)from_a));
+		to_a += 32;
+		from_a += 32;
+	}
+}
+
+#endif // DO_BUILD_AVX2
+
+OODLE_NS_END
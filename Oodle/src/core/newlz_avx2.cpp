@@ -0,0 +1,111 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+// This source file is licensed solely to users who have
+// accepted a valid Unreal Engine license agreement 
+// (see e.g., https://www.unrealengine.com/eula), and use
+// of this source file is governed by such agreement.
+
+// @cdep pre $cbtargetavx2
+
+#include "oodlebase.h"
+#include "oodlelzcompressors.h"
+
+#include "rrlzh_lzhlw_shared.h"
+#include "newlz.h"
+#include "newlz_simd.h"
+#include "newlz_subliterals.h"
+#include "newlz_offsets.h"
+#include "newlz_decoder.h"
+
+#define CHECK(x)
+
+//#include "rrsimpleprof.h"
+#include "rrsimpleprofstub.h"
+
+//=============================================================================
+
+#ifdef DO_BUILD_AVX2
+
+#include <immintrin.h>
+
+OODLE_NS_START
+
+/***
+
+newlz (Kraken) avx2 decoder
+
+same as the sse4 decoder (same last offsets) ; the difference is in the long LRL and
+long ML paths, which copy 32 bytes per step instead of 8.  See NEWLZ_DECODE_COPY32.
+
+Selected by newlz_simd_has_avx2_bulk, like the newlzf avx2 decoder.
+
+***/
+
+#include "newlz_los_sse4.inl"
+
+#define newlz_copy32(to,from)	_mm256_storeu_si256((__m256i *)(to),_mm256_loadu_si256((const __m256i *)(from)))
+
+// copy [to,to_end) in 32 byte steps ; the last step is aligned to to_end
+//	so it can back up before to : [to_end-32,to) must be part of the same run, already written
+//	from is either a separate buffer or at least 32 behind to
+static RADFORCEINLINE void newlz_copy32_to_end(U8 * to, const U8 * from, U8 * to_end)
+{
+	RR_ASSERT( to < to_end );
+	const U8 * from_end = from + rrPtrDiff(to_end - to);
+	while ( rrPtrDiff(to_end - to) > 32 )
+	{
+		newlz_copy32(to,from);
+		to += 32;
+		from += 32;
+	}
+	newlz_copy32(to_end-32,from_end-32);
+}
+
+// sub literals : to[i] = lits[i] + to[i+neg_offset]
+//	same rules as newlz_copy32_to_end ; neg_offset <= -32
+static RADFORCEINLINE void newlz_literals_sub32_to_end(U8 * to, SINTa neg_offset, const U8 * lits, U8 * to_end)
+{
+	RR_ASSERT( to < to_end );
+	RR_ASSERT( neg_offset <= -32 );
+	const U8 * lits_end = lits + rrPtrDiff(to_end - to);
+	while ( rrPtrDiff(to_end - to) > 32 )
+	{
+		__m256i l = _mm256_loadu_si256((const __m256i *)lits);
+		__m256i m = _mm256_loadu_si256((const __m256i *)(to + neg_offset));
+		_mm256_storeu_si256((__m256i *)to,_mm256_add_epi8(l,m));
+		to += 32;
+		lits += 32;
+	}
+	to = to_end-32;
+	lits = lits_end-32;
+	__m256i l = _mm256_loadu_si256((const __m256i *)lits);
+	__m256i m = _mm256_loadu_si256((const __m256i *)(to + neg_offset));
+	_mm256_storeu_si256((__m256i *)to,_mm256_add_epi8(l,m));
+}
+
+#undef NEWLZ_DECODE_COPY32
+#define NEWLZ_DECODE_COPY32	1
+
+//=============================================================================
+
+#define NEWLZ_DECODE_LITERALS_TYPE	NEWLZ_LITERALS_TYPE_RAW
+#define newLZ_decode_parse	newLZ_decode_parse_raw_avx2
+#include "newlz_decode_parse_outer.inl"
+#undef newLZ_decode_parse
+#undef NEWLZ_DECODE_LITERALS_TYPE
+
+#define NEWLZ_DECODE_LITERALS_TYPE	NEWLZ_LITERALS_TYPE_SUB
+#define newLZ_decode_parse	newLZ_decode_parse_sub_avx2
+#include "newlz_decode_parse_outer.inl"
+#undef newLZ_decode_parse
+#undef NEWLZ_DECODE_LITERALS_TYPE
+
+const newLZ_decode_parse_func_set newLZ_decode_parse_funcs_avx2 =
+{
+	newLZ_decode_parse_raw_avx2,
+	newLZ_decode_parse_sub_avx2,
+};
+
+OODLE_NS_END
+
+#endif // DO_BUILD_AVX2
+
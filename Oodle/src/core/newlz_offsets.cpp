@@ -1635,7 +1635,9 @@ S32 newLZ_get_offsets_excesses(const U8 * const comp_ptr, const U8 * const chunk
 			// Run the decoder kernel
 			#if defined(__RADX86__)
 
-			if ( newlz_simd_has_avx2() )
+			if ( newlz_simd_has_avx512_bulk() )
+				decode_ok = newLZ_offset44_decode_avx512(&s);
+			else if ( newlz_simd_has_avx2() )
 				decode_ok = newLZ_offset44_decode_avx2(&s);
 			else if ( newlz_simd_has_sse4() )
 				decode_ok = newLZ_offset44_decode_sse4(&s);
@@ -1671,7 +1673,9 @@ S32 newLZ_get_offsets_excesses(const U8 * const comp_ptr, const U8 * const chunk
 
 			#if defined(__RADX86__)
 
-			if ( newlz_simd_has_avx2() )
+			if ( newlz_simd_has_avx512_bulk() )
+				decode_ok = newLZ_offsetalt_decode_avx512(&s);
+			else if ( newlz_simd_has_avx2() )
 				decode_ok = newLZ_offsetalt_decode_avx2(&s);
 			else if ( newlz_simd_has_sse4() )
 				decode_ok = newLZ_offsetalt_decode_sse4(&s);
@@ -0,0 +1,264 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+// This source file is licensed solely to users who have
+// accepted a valid Unreal Engine license agreement 
+// (see e.g., https://www.unrealengine.com/eula), and use
+// of this source file is governed by such agreement.
+
+// @cdep pre $cbtargetavx512
+#include "newlz_offsets.h"
+#include "newlz_simd.h"
+
+//#include "rrsimpleprof.h"
+#include "rrsimpleprofstub.h"
+
+OODLE_NS_START
+
+#ifdef DO_BUILD_AVX512
+
+OODLE_NS_END
+#include <immintrin.h>
+OODLE_NS_START
+
+/**
+
+AVX-512 (F/BW/VL/VBMI/VBMI2) offset decoders, 16 offsets per iteration
+
+offsets alternate between the two bit streams, so that's 8 fields from each
+both streams are read MSB first ; the backward one goes down in memory
+
+a zmm holds 32 bytes of each stream :
+	bytes [0,32) are the forward stream from bitp0
+	bytes [32,64) are loaded from bitp1 - 32, so byte j of the backward stream is at 63 - j
+
+8 fields of up to 29 bits plus 7 bits of start position fit in 32 bytes
+
+each lane gets its field by gathering the 4 bytes at its start byte as a big-endian
+dword and the byte after that (VBMI permutexvar), funnel shifting left by the
+start bit (VBMI2 shldv) and then shifting down to the field width
+
+**/
+
+// byte (4*i + k) = lane i of a U8 vector ; splats each U8 across its dword
+static const U8 c_offsets_avx512_splat_u8_to_u32[64] =
+{
+	0,0,0,0, 1,1,1,1, 2,2,2,2, 3,3,3,3, 4,4,4,4, 5,5,5,5, 6,6,6,6, 7,7,7,7,
+	8,8,8,8, 9,9,9,9, 10,10,10,10, 11,11,11,11, 12,12,12,12, 13,13,13,13, 14,14,14,14, 15,15,15,15
+};
+
+// Returns the numraw_u8[i] bit field for offset i, 16 offsets
+// the start bit positions come from the prefix sum of numraw (even offsets forward stream, odd offsets backward)
+// advances *pinitial_bit and returns the byte advance for each stream
+static RADFORCEINLINE __m512i offsets_getbits16_avx512(__m512i bytes, __m128i numraw_u8, __m512i numraw32, __m128i * pinitial_bit, U32 * padvance0, U32 * padvance1)
+{
+	// Prefix sum to work out end bit for each field
+	// we're summing both the forward and backward stream counts here
+	__m128i pfx0 = _mm_add_epi8(numraw_u8, *pinitial_bit);
+	__m128i pfx1 = _mm_add_epi8(pfx0, _mm_bslli_si128(pfx0, 2));
+	__m128i pfx2 = _mm_add_epi8(pfx1, _mm_bslli_si128(pfx1, 4));
+	__m128i end_bit_index_u8 = _mm_add_epi8(pfx2, _mm_bslli_si128(pfx2, 8));
+	__m128i start_bit_index_u8 = _mm_sub_epi8(end_bit_index_u8, numraw_u8);
+
+	// Bit buffer advance comes from the last field of each stream (lanes 14/15)
+	U32 last_end_bits = (U32)_mm_extract_epi16(end_bit_index_u8, 7);
+	*padvance0 = (last_end_bits & 0xff) >> 3;
+	*padvance1 = last_end_bits >> 11;
+	*pinitial_bit = _mm_and_si128(_mm_cvtsi32_si128(last_end_bits), _mm_set1_epi8(7));
+
+	// Work out byte permute indices
+	// forward lanes want bytes (sb+3,sb+2,sb+1,sb), backward lanes want (60-sb,61-sb,62-sb,63-sb)
+	// index_next is +4 / -4 per byte
+	// the 'lo' dword only contributes its top byte, which is the byte after those
+	__m128i start_byte_index_u8 = _mm_and_si128(_mm_srli_epi16(start_bit_index_u8, 3), _mm_set1_epi8(0x1f));
+	__m512i start_byte_x4 = _mm512_permutexvar_epi8(_mm512_loadu_si512(c_offsets_avx512_splat_u8_to_u32), _mm512_castsi128_si512(start_byte_index_u8));
+
+	const __mmask64 backward_lanes = 0xF0F0F0F0F0F0F0F0ULL;
+	const __m512i index_base = _mm512_set_epi32(
+		0x3f3e3d3c,0x00010203, 0x3f3e3d3c,0x00010203, 0x3f3e3d3c,0x00010203, 0x3f3e3d3c,0x00010203,
+		0x3f3e3d3c,0x00010203, 0x3f3e3d3c,0x00010203, 0x3f3e3d3c,0x00010203, 0x3f3e3d3c,0x00010203);
+	const __m512i index_next = _mm512_set_epi32(
+		(int)0xfcfcfcfc,0x04040404, (int)0xfcfcfcfc,0x04040404, (int)0xfcfcfcfc,0x04040404, (int)0xfcfcfcfc,0x04040404,
+		(int)0xfcfcfcfc,0x04040404, (int)0xfcfcfcfc,0x04040404, (int)0xfcfcfcfc,0x04040404, (int)0xfcfcfcfc,0x04040404);
+
+	__m512i index_hi = _mm512_mask_sub_epi8(_mm512_add_epi8(index_base, start_byte_x4), backward_lanes, index_base, start_byte_x4);
+	__m512i index_lo = _mm512_add_epi8(index_hi, index_next);
+
+	__m512i dwords_hi = _mm512_permutexvar_epi8(index_hi, bytes);
+	__m512i dwords_lo = _mm512_permutexvar_epi8(index_lo, bytes);
+
+	// top 32 bits starting at the start bit, then down to the field width
+	__m512i start_bit = _mm512_and_si512(_mm512_cvtepu8_epi32(start_bit_index_u8), _mm512_set1_epi32(7));
+	__m512i bits = _mm512_shldv_epi32(dwords_hi, dwords_lo, start_bit);
+	return _mm512_srlv_epi32(bits, _mm512_sub_epi32(_mm512_set1_epi32(32), numraw32));
+}
+
+static RADFORCEINLINE __m512i offsets_load_streams_avx512(const U8 * bitp0, const U8 * bitp1)
+{
+	__m512i bytes = _mm512_castsi256_si512(_mm256_loadu_si256((const __m256i *)bitp0));
+	return _mm512_inserti64x4(bytes, _mm256_loadu_si256((const __m256i *)bitp1), 1);
+}
+
+bool newLZ_offset44_decode_avx512(KrakenOffsetState * s)
+{
+	const U8 * offs_u8 = s->offs_u8;
+	const U8 * offs_u8_end = s->offs_u8_end;
+	SIMPLEPROFILE_SCOPE_N(offsets44_dec_avx512, offs_u8_end-offs_u8);
+
+	if (offs_u8_end - offs_u8 >= 16 && s->bitp[1] - s->bitp[0] >= 32)
+	{
+		offs_u8_end -= 15;
+
+		S32 * neg_offs_s32 = s->neg_offs_s32;
+		const U8 * bitp0 = s->bitp[0];
+		const U8 * bitp1 = s->bitp[1] - 32;
+
+		const __m128i const_0xf0 = _mm_set1_epi8(0xf0 - 0x100);
+		const __m128i const_0x0f = _mm_set1_epi8(0x0f);
+		const __m512i offs_bias = _mm512_set1_epi32((1<<(OFFSET_RAW_BITS + 4)) - NEWLZ_MIN_OFFSET);
+		const __m512i escape_bias = _mm512_set1_epi32(-ESCAPE_OFFSET_BIAS);
+		__m128i initial_bit = _mm_cvtsi32_si128(s->bitc[0] | (s->bitc[1] << 8)); // starting bit position within initial byte in lanes 0/1 (rest zero)
+
+		while (offs_u8 < offs_u8_end && bitp0 <= bitp1)
+		{
+			// Grab the next 16 offset_u8s and split them up
+			__m128i offset_u8 = _mm_loadu_si128((const __m128i *) offs_u8);
+
+			// 0xfe and 0xff would be numraw >= 30 which is not legal
+			if (_mm_cmpgt_epu8_mask(offset_u8, _mm_set1_epi8(0xfd - 0x100)))
+				return false;
+
+			__mmask16 offs_islarge = _mm_cmpeq_epi8_mask(_mm_and_si128(offset_u8, const_0xf0), const_0xf0);
+			__m128i offset_lo_nib = _mm_and_si128(offset_u8, const_0x0f);
+			__m128i offset_hi_nib = _mm_and_si128(_mm_srli_epi16(offset_u8, 4), const_0x0f);
+
+			// raw bit count is hi+OFFSET_RAW_BITS for small offsets, lo+16 for large
+			__m128i numraw = _mm_mask_add_epi8(_mm_add_epi8(offset_hi_nib, _mm_set1_epi8(OFFSET_RAW_BITS)),
+				offs_islarge, offset_lo_nib, _mm_set1_epi8(16));
+			__m512i numraw32 = _mm512_cvtepu8_epi32(numraw);
+
+			U32 advance0, advance1;
+			__m512i offs_bits = offsets_getbits16_avx512(offsets_load_streams_avx512(bitp0, bitp1), numraw, numraw32, &initial_bit, &advance0, &advance1);
+			bitp0 += advance0;
+			bitp1 -= advance1;
+
+			// Set the top bit
+			__m512i offs_masked = _mm512_or_si512(offs_bits, _mm512_sllv_epi32(_mm512_set1_epi32(1), numraw32));
+
+			// Compute the negated offsets for the small and large offset case
+			__m512i neg_offs = _mm512_sub_epi32(offs_bias, _mm512_slli_epi32(offs_masked, 4));
+			neg_offs = _mm512_sub_epi32(neg_offs, _mm512_cvtepu8_epi32(offset_lo_nib));
+			neg_offs = _mm512_mask_sub_epi32(neg_offs, offs_islarge, escape_bias, offs_masked);
+
+			// Store offsets
+			_mm512_storeu_si512(neg_offs_s32, neg_offs);
+
+			#if NEWLZ_OFFSET_DECODE_DEBUG
+			for (int i = 0; i < 16; i++)
+				OFFSET_CHECK(&neg_offs_s32[i]);
+			#endif
+
+			// Advance output buffer pointers
+			offs_u8 += 16;
+			neg_offs_s32 += 16;
+		}
+
+		s->offs_u8 = offs_u8;
+		s->neg_offs_s32 = neg_offs_s32;
+
+		U16 final_bit_offs = (U16)_mm_extract_epi16(initial_bit, 0);
+
+		s->bitp[0] = bitp0;
+		s->bitp[1] = bitp1 + 32;
+		s->bitc[0] = final_bit_offs & 7;
+		s->bitc[1] = final_bit_offs >> 8;
+	}
+
+	return newLZ_offset44_decode_finish(s);
+}
+
+bool newLZ_offsetalt_decode_avx512(KrakenOffsetState * s)
+{
+	const U8 * offs_u8 = s->offs_u8;
+	const U8 * offs_u8_end = s->offs_u8_end;
+	SIMPLEPROFILE_SCOPE_N(offsetsalt_dec_avx512, offs_u8_end-offs_u8);
+
+	if (offs_u8_end - offs_u8 >= 16 && s->bitp[1] - s->bitp[0] >= 32)
+	{
+		offs_u8_end -= 15;
+
+		S32 * neg_offs_s32 = s->neg_offs_s32;
+		const U8 * bitp0 = s->bitp[0];
+		const U8 * bitp1 = s->bitp[1] - 32;
+
+		const U8 OFFSET_ALT_UNDER_MASK  = (1 << OFFSET_ALT_NUM_UNDER_BITS) - 1;
+		const __m512i alt_bias = _mm512_set1_epi32(OFFSET_ALT_BIAS);
+		__m128i initial_bit = _mm_cvtsi32_si128(s->bitc[0] | (s->bitc[1] << 8)); // starting bit position within initial byte in lanes 0/1 (rest zero)
+
+		while (offs_u8 < offs_u8_end && bitp0 <= bitp1)
+		{
+			// Grab the next 16 offset_u8s
+			__m128i offset_u8 = _mm_loadu_si128((const __m128i *) offs_u8);
+
+			// Work out raw bit counts ; anything over OFFSET_ALT_MAX_NUM_RAW_BITS is corrupt
+			__m128i numraw = _mm_and_si128(_mm_srli_epi16(offset_u8, OFFSET_ALT_NUM_UNDER_BITS), _mm_set1_epi8(0xff >> OFFSET_ALT_NUM_UNDER_BITS));
+			if (_mm_cmpgt_epu8_mask(numraw, _mm_set1_epi8(OFFSET_ALT_MAX_NUM_RAW_BITS)))
+				return false;
+			__m512i numraw32 = _mm512_cvtepu8_epi32(numraw);
+
+			U32 advance0, advance1;
+			__m512i offs_bits = offsets_getbits16_avx512(offsets_load_streams_avx512(bitp0, bitp1), numraw, numraw32, &initial_bit, &advance0, &advance1);
+			bitp0 += advance0;
+			bitp1 -= advance1;
+
+			// high bits are the under bits with the implicit top bit above them
+			__m128i hibits_u8 = _mm_or_si128(_mm_and_si128(offset_u8, _mm_set1_epi8(OFFSET_ALT_UNDER_MASK)), _mm_set1_epi8(OFFSET_ALT_UNDER_MASK + 1));
+			__m512i hibits32 = _mm512_sllv_epi32(_mm512_cvtepu8_epi32(hibits_u8), numraw32);
+
+			// Compute the negated offsets, taking care of the bias along the way
+			__m512i neg_offs = _mm512_sub_epi32(alt_bias, _mm512_or_si512(offs_bits, hibits32));
+
+			// Store offsets
+			_mm512_storeu_si512(neg_offs_s32, neg_offs);
+
+			#if NEWLZ_OFFSET_DECODE_DEBUG
+			for (int i = 0; i < 16; i++)
+				OFFSET_CHECK(&neg_offs_s32[i]);
+			#endif
+
+			// Advance output buffer pointers
+			offs_u8 += 16;
+			neg_offs_s32 += 16;
+		}
+
+		s->offs_u8 = offs_u8;
+		s->neg_offs_s32 = neg_offs_s32;
+
+		U16 final_bit_offs = (U16)_mm_extract_epi16(initial_bit, 0);
+
+		s->bitp[0] = bitp0;
+		s->bitp[1] = bitp1 + 32;
+		s->bitc[0] = final_bit_offs & 7;
+		s->bitc[1] = final_bit_offs >> 8;
+	}
+
+	return newLZ_offsetalt_decode_finish(s);
+}
+
+#else // DO_BUILD_AVX512
+
+bool newLZ_offset44_decode_avx512(KrakenOffsetState * s)
+{
+	RR_ASSERT_FAILURE_ALWAYS("should not get here");
+
+	return newLZ_offset44_decode_finish(s);
+}
+
+bool newLZ_offsetalt_decode_avx512(KrakenOffsetState * s)
+{
+	RR_ASSERT_FAILURE_ALWAYS("should not get here");
+
+	return newLZ_offsetalt_decode_finish(s);
+}
+
+#endif // DO_BUILD_AVX512
+
+OODLE_NS_END
@@ -233,6 +233,11 @@ the difference is mostly packing
 */
 S32 simd_dotproduct_s16_s16_256(const S16 * v1, const S16 * v2)
 {
+	#ifdef DO_BUILD_AVX2
+	if ( newlz_simd_has_avx2_bulk() )
+		return simd_dotproduct_s16_s16_256_avx2(v1,v2);
+	#endif
+
 	#ifdef __RADSSE2__
 	
 	__m128i accum = _mm_setzero_si128();
@@ -276,6 +281,11 @@ S32 simd_dotproduct_s16_s16_256(const S16 * v1, const S16 * v2)
 		
 S32 simd_dotproduct_s32_s16_256(const S32 * v1, bool v1_fits_in_S16, const S16 * v2)
 {
+	#ifdef DO_BUILD_AVX2
+	if ( newlz_simd_has_avx2_bulk() )
+		return simd_dotproduct_s32_s16_256_avx2(v1,v1_fits_in_S16,v2);
+	#endif
+
 	#if defined(__RADSSE2__)
 	
 	__m128i accum = _mm_setzero_si128();
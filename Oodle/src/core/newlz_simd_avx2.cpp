@@ -0,0 +1,87 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+// This source file is licensed solely to users who have
+// accepted a valid Unreal Engine license agreement 
+// (see e.g., https://www.unrealengine.com/eula), and use
+// of this source file is governed by such agreement.
+
+// @cdep pre $cbtargetavx2
+#include "newlz_simd.h"
+
+OODLE_NS_START
+
+#ifdef DO_BUILD_AVX2
+
+OODLE_NS_END
+#include <immintrin.h>
+OODLE_NS_START
+
+static RADFORCEINLINE S32 hsum_epi32_avx2(__m256i x)
+{
+	__m128i x128 = _mm_add_epi32(_mm256_castsi256_si128(x), _mm256_extracti128_si256(x, 1));
+	return hsum_epi32_sse2(x128);
+}
+
+S32 simd_dotproduct_s16_s16_256_avx2(const S16 * v1, const S16 * v2)
+{
+	__m256i accum0 = _mm256_setzero_si256();
+	__m256i accum1 = _mm256_setzero_si256();
+	
+	for(int s=0;s<256;s+=32)
+	{
+		__m256i counts0 = _mm256_loadu_si256((const __m256i *)(v1+s));
+		__m256i counts1 = _mm256_loadu_si256((const __m256i *)(v1+s+16));
+		__m256i codelens0 = _mm256_loadu_si256((const __m256i *)(v2+s));
+		__m256i codelens1 = _mm256_loadu_si256((const __m256i *)(v2+s+16));
+		
+		accum0 = _mm256_add_epi32( accum0, _mm256_madd_epi16(counts0,codelens0) );
+		accum1 = _mm256_add_epi32( accum1, _mm256_madd_epi16(counts1,codelens1) );
+	}
+	
+	return hsum_epi32_avx2( _mm256_add_epi32(accum0,accum1) );
+}
+
+S32 simd_dotproduct_s32_s16_256_avx2(const S32 * v1, bool v1_fits_in_S16, const S16 * v2)
+{
+	__m256i accum0 = _mm256_setzero_si256();
+	__m256i accum1 = _mm256_setzero_si256();
+	
+	if ( v1_fits_in_S16 )
+	{
+		for(int s=0;s<256;s+=16)
+		{
+			__m256i counts1 = _mm256_loadu_si256((const __m256i *)(v1+s));
+			__m256i counts2 = _mm256_loadu_si256((const __m256i *)(v1+s+8));
+			
+			// packs works within 128-bit lanes, so counts come out as
+			//	[0-3 8-11 | 4-7 12-15] ; permute the codelens the same way
+			//	the sum doesn't care about order
+			__m256i counts_s16 = _mm256_packs_epi32(counts1,counts2);
+			
+			__m256i codelens = _mm256_loadu_si256((const __m256i *)(v2+s));
+			codelens = _mm256_permute4x64_epi64(codelens, _MM_SHUFFLE(3,1,2,0));
+			
+			accum0 = _mm256_add_epi32( accum0, _mm256_madd_epi16(counts_s16,codelens) );
+		}
+	}
+	else
+	{
+		for(int s=0;s<256;s+=16)
+		{
+			__m256i counts1 = _mm256_loadu_si256((const __m256i *)(v1+s));
+			__m256i counts2 = _mm256_loadu_si256((const __m256i *)(v1+s+8));
+			
+			// codelens are non-negative ; zero extend :
+			__m256i codelens1 = _mm256_cvtepu16_epi32(_mm_loadu_si128((const __m128i *)(v2+s)));
+			__m256i codelens2 = _mm256_cvtepu16_epi32(_mm_loadu_si128((const __m128i *)(v2+s+8)));
+			
+			accum0 = _mm256_add_epi32( accum0, _mm256_mullo_epi32(counts1,codelens1) );
+			accum1 = _mm256_add_epi32( accum1, _mm256_mullo_epi32(counts2,codelens2) );
+		}
+	}
+	
+	return hsum_epi32_avx2( _mm256_add_epi32(accum0,accum1) );
+}
+
+#endif // DO_BUILD_AVX2
+
+OODLE_NS_END
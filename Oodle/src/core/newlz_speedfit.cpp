@@ -155,6 +155,17 @@ static F32 speedfit_default_rle(SINTa len)
 	return speedfit_blend(ivb, a57, jag, skl);
 }
 
+static F32 speedfit_default_rans(SINTa len, SINTa num_non_zero)
+{
+	// table build is a fixed 4k entries ; per-byte rate assumes the AVX2 decoder
+	F32 ivb = 2790.000f + 2.980f * len + 14.000f * num_non_zero;
+	F32 a57 = 3410.000f + 3.350f * len + 24.000f * num_non_zero;
+	F32 jag = 4310.000f + 4.120f * len + 22.000f * num_non_zero;
+	F32 skl = 2620.000f + 1.790f * len + 12.000f * num_non_zero;
+
+	return speedfit_blend(ivb, a57, jag, skl);
+}
+
 #define SPEEDFIT_PARSE_CONSTANT_TIME	200.f
 
 static F32 speedfit_default_parse_Selkie(SINTa chunk_len, SINTa num_packets, SINTa num_escapes, SINTa num_literals)
@@ -286,6 +297,7 @@ static const OodleSpeedFit g_speedfit_default =
 	speedfit_default_huff6,
 	speedfit_default_tans,
 	speedfit_default_rle,
+	speedfit_default_rans,
 
 	speedfit_default_parse_Selkie,
 	speedfit_default_parse_Mermaid,
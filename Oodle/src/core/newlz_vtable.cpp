@@ -100,6 +100,7 @@ SINTa newlz_enc_mem_bound(newlz_vtable * vtable,SINTa wholeRawLen)
 	}
 			
 	if ( (vtable->entropy_flags & NEWLZ_ARRAY_FLAG_ALLOW_TANS) ||
+		(vtable->entropy_flags & NEWLZ_ARRAY_FLAG_ALLOW_RANS) ||
 		(vtable->entropy_flags & NEWLZ_ARRAY_FLAG_ALLOW_RLEHUFF) )
 	{
 		// entropy modes that need a temp array
@@ -789,6 +790,9 @@ static SINTa newlz_compress_vtable_sub(
 
 		scratch->matches_space.extend( match_space_needed, arena);
 		match_base = (UnpackedMatchPair *)scratch->matches_space.m_ptr;
+		// the optimal parsers look up matches[pos] all over the block ; skip user scratch from the arena :
+		if ( scratch->matches_space.m_freeptr )
+			OodleMemoryHint(match_base,match_space_needed,OODLE_MEMORY_HINT_LARGE_RANDOM_ACCESS);
 	}
 
 	// Set up the parse jobs
@@ -966,9 +970,16 @@ static void OODLE_CALLBACK newlz_compress_create_match_finder(void *job_data)
 		lrmset = &job->lrmset_mem;
 		lrmset->lrms.clear();
 		if ( job->lrmcasc_incr )
+		{
 			LRM_CascadeGetSet_Align_UpdateIncremental(job->lrmcasc_incr,lrmset,job->dictionaryStartPtr,job->raw_ptr);
+		}
 		else
-			LRM_CascadeGetSet_Align(job->lrmcasc,lrmset,job->dictionaryStartPtr,job->raw_ptr);
+		{
+			// a cascade from OodleLZ_CreateLRM may stop short of the local window
+			//	(the client didn't extend it over all the new data) ; just use all of it
+			const U8 * lrmStartPtr = RR_MIN(job->dictionaryStartPtr,LRM_GetCascadeEndPtr(job->lrmcasc));
+			LRM_CascadeGetSet_Align(job->lrmcasc,lrmset,lrmStartPtr,job->raw_ptr);
+		}
 
 		rrPrintf_v2("LRM covers to " RR_UINTa_FMT " ; dicBackup starts at " RR_UINTa_FMT "\n",
 			rrPtrDiff(LRMSet_GetEndPtr(lrmset) - job->dictionaryBase),rrPtrDiff(job->dictionaryStartPtr - job->dictionaryBase));
@@ -1047,8 +1058,6 @@ SINTa newlz_compress_vtable(newlz_vtable * vtable,
 	UINTa next_retire_job = 0;
 	UINTa cmf_job_count = (pOptions->jobify == OodleLZ_Jobify_Aggressive) ? 2 : 1;
 
-	RR_ASSERT_ALWAYS( cmf_job_count >= 1 && cmf_job_count <= MAX_CMF_JOBS );
-
 	const U8 * pointerToPos0 = dictionaryBase;
 
 	// this math is all really foogly
@@ -1107,7 +1116,13 @@ SINTa newlz_compress_vtable(newlz_vtable * vtable,
 					// make LRM cascade :
 					//	we make LRM for the region that the last chunk will not see in its dic backup :
 					//casc_local = LRM_CreateCascade(dictionaryBase,last_chunk_dic_start,g_OodleLZ_LW_LRM_step,g_OodleLZ_LW_LRM_jumpbits,0,maxSubSize,g_OodleLZ_LW_LRM_hashLength);
-					casc_local = LRM_CreateCascadeIncremental(dictionaryBase,last_chunk_dic_start,g_OodleLZ_LW_LRM_step,g_OodleLZ_LW_LRM_jumpbits,0,maxSubSize,g_OodleLZ_LW_LRM_hashLength);
+					// with a job system, build the whole cascade up front as a job DAG
+					//	(we're on the calling thread here so it's okay to wait)
+					//	otherwise fill it in serially as the chunks need it
+					if ( pOptions->jobify != OodleLZ_Jobify_Disable && Oodle_IsJobSystemSet() )
+						casc_local = LRM_CreateCascadeJobified(dictionaryBase,last_chunk_dic_start,g_OodleLZ_LW_LRM_step,g_OodleLZ_LW_LRM_jumpbits,0,maxSubSize,g_OodleLZ_LW_LRM_hashLength,pOptions->jobifyUserPtr);
+					else
+						casc_local = LRM_CreateCascadeIncremental(dictionaryBase,last_chunk_dic_start,g_OodleLZ_LW_LRM_step,g_OodleLZ_LW_LRM_jumpbits,0,maxSubSize,g_OodleLZ_LW_LRM_hashLength);
 
 					casc = casc_local;
 				}
@@ -1127,6 +1142,20 @@ SINTa newlz_compress_vtable(newlz_vtable * vtable,
 		RR_ASSERT( ((maxLocalDictionarySize/casc_chunk)*casc_chunk) == maxLocalDictionarySize );
 	}
 
+	// a match finder that jobifies its own construction must be created on this thread
+	//	(WaitJob can't be called from inside a job)
+	//	only give up the create/parse overlap if it fans out at our biggest window
+	if ( vtable->fp_create_match_finder_runs_jobs )
+	{
+		SINTa cmf_max_size = pOptions->seekChunkReset ? maxSubSize : RR_MAX(maxSubSize,maxLocalDictionarySize);
+		cmf_max_size = RR_MIN(cmf_max_size,rawLenPlusBackup);
+		
+		if ( vtable->fp_create_match_finder_runs_jobs(cmf_max_size,pOptions->jobify) )
+			cmf_job_count = 1;
+	}
+
+	RR_ASSERT_ALWAYS( cmf_job_count >= 1 && cmf_job_count <= MAX_CMF_JOBS );
+
 	SINTa totCompLen = 0;
 	for (;;)
 	{
@@ -3076,15 +3076,25 @@ static SINTa newLZF_encode_chunk_fast_mode(const newlz_vtable * vtable,
 				SINTa match_offs; // or 0 for LO
 				SINTa neg_offset;
 				SINTa scaled_skip_dist = 1 << t_step_literals_shift;
+				UINTa hash = fast_ctmf_hash(RR_GET64_LE_UNALIGNED(ptr), hash_mul, hash_shift);
 
 				for(;;)
 				{
 					U64 ptr64le = RR_GET64_LE_UNALIGNED(ptr);
 					U32 ptr32le = (U32)ptr64le;
 
-					// hash lookup and insert
+					// where we go if there's no match here :
+					SINTa step = scaled_skip_dist >> t_step_literals_shift;
 					SINTa pos = rrPtrDiff(ptr - hash_base);
-					HashType hashpos = fast_ctmf_insert(hash_table, ptr64le, hash_mul, hash_shift, pos);
+
+					// start the next probe's loads before we look at this one
+					//	(when there's no room, the loop ends below unless we match here)
+					UINTa hash_next = 0;
+					if ( rrPtrDiff(parse_end_ptr - ptr) > step )
+						hash_next = fast_ctmf_pipeline_next(hash_table, ptr + step, pos + step, hash_mul, hash_shift);
+
+					// hash lookup and insert
+					HashType hashpos = fast_ctmf_insert_hashed(hash_table, hash, pos);
 
 					// check for rep0 match *at next byte* (pseudo-lazy), MML 3
 					U32 lodiff = ptr32le ^ RR_GET32_LE_UNALIGNED(ptr+neg_lo0);
@@ -3151,8 +3161,6 @@ static SINTa newLZF_encode_chunk_fast_mode(const newlz_vtable * vtable,
 
 					// no match found, skip ahead
 					// check if we can step as far as we want to
-					SINTa step = scaled_skip_dist >> t_step_literals_shift;
-
 					if ( rrPtrDiff(parse_end_ptr - ptr) <= step )
 						goto parse_chunk_done;
 
@@ -3172,6 +3180,7 @@ static SINTa newLZF_encode_chunk_fast_mode(const newlz_vtable * vtable,
 						scaled_skip_dist++;
 
 					ptr += step;
+					hash = hash_next;
 				}
 
 				// normal match is < parse_end_ptr; lo0 can be == parse_end_ptr
@@ -3987,6 +3996,28 @@ static RADINLINE SINTa newLZF_decode_chunk_phase2(int chunk_type,const U8 * comp
 		{
 			RR_ASSERT_IF_NOT_CORRUPT( arrays->escape_offsets_count1 == 0 );
 		
+			#ifdef DO_BUILD_AVX2
+			if ( newlz_simd_has_avx2_bulk() )
+			{
+				if ( chunk_type == NEWLZ_LITERALS_TYPE_RAW )
+				{
+					comp_ptr = newLZF_decode_parse_raw_avx2_first(chunk_ptr,chunk_len,
+										block_end,window_base,
+										comp_end,
+										arrays,&neg_offset
+										);	
+				}
+				else
+				{	
+					comp_ptr = newLZF_decode_parse_sub_avx2_first(chunk_ptr,chunk_len,
+										block_end,window_base,
+										comp_end,
+										arrays,&neg_offset
+										);	
+				}
+			}
+			else
+			#endif
 			#if defined(DO_SSE4_TEST) || defined(DO_SSE4_ALWAYS)
 			if ( newlz_simd_has_sse4() )
 			{
@@ -4037,6 +4068,28 @@ static RADINLINE SINTa newLZF_decode_chunk_phase2(int chunk_type,const U8 * comp
 		}
 		else
 		{
+			#ifdef DO_BUILD_AVX2
+			if ( newlz_simd_has_avx2_bulk() )
+			{
+				if ( chunk_type == NEWLZ_LITERALS_TYPE_RAW )
+				{
+					comp_ptr = newLZF_decode_parse_raw_avx2(chunk_ptr,chunk_len,
+										block_end,window_base,
+										comp_end,
+										arrays,&neg_offset
+										);	
+				}
+				else
+				{	
+					comp_ptr = newLZF_decode_parse_sub_avx2(chunk_ptr,chunk_len,
+										block_end,window_base,
+										comp_end,
+										arrays,&neg_offset
+										);	
+				}
+			}
+			else
+			#endif
 			#if defined(DO_SSE4_TEST) || defined(DO_SSE4_ALWAYS)
 			if ( newlz_simd_has_sse4() )
 			{
@@ -0,0 +1,147 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+// This source file is licensed solely to users who have
+// accepted a valid Unreal Engine license agreement 
+// (see e.g., https://www.unrealengine.com/eula), and use
+// of this source file is governed by such agreement.
+
+// @cdep pre $cbtargetavx2
+
+#include "oodlebase.h"
+#include "cbradutil.h"
+#include <stdlib.h>
+
+#include "oodlelzcompressors.h"
+#include "newlzf.h"
+
+#include "newlz_simd.h"
+
+#include "rrbits.h"
+#include "rrprefetch.h"
+#include "rrlzh_lzhlw_shared.h"
+#include "newlz_subliterals.h"
+#include "newlzf_decoder.h"
+
+//#include "rrsimpleprof.h"
+#include "rrsimpleprofstub.h"
+
+#define CHECK(x)
+
+OODLE_NS_START
+
+//==================================================================================================
+#ifdef DO_BUILD_AVX2
+
+OODLE_NS_END
+#include <immintrin.h>
+OODLE_NS_START
+
+/***
+
+newlzf avx2 decoder
+
+same as the sse4 decoder (same simple packet macros) ; the difference is in the
+long escapes (LRL escape and long ML), which copy 32 bytes per step instead of 8 or 16.
+See NEWLZF_DECODE_COPY32.
+
+Selected by newlz_simd_has_avx2_bulk ; the 256-bit ops here are only loads, stores and
+byte adds, which don't drop the clock on the Intel parts that have AVX2 license levels.
+
+***/
+
+#define newlzf_copy32(to,from)	_mm256_storeu_si256((__m256i *)(to),_mm256_loadu_si256((const __m256i *)(from)))
+
+// copy [to,to_end) in 32 byte steps ; the last step is aligned to to_end
+//	needs to_end - to >= 32 and from either a separate buffer or at least 32 behind to
+static RADFORCEINLINE void newlzf_copy32_to_end(U8 * to, const U8 * from, U8 * to_end)
+{
+	RR_ASSERT( rrPtrDiff(to_end - to) >= 32 );
+	const U8 * from_end = from + rrPtrDiff(to_end - to);
+	while ( rrPtrDiff(to_end - to) > 32 )
+	{
+		newlzf_copy32(to,from);
+		to += 32;
+		from += 32;
+	}
+	newlzf_copy32(to_end-32,from_end-32);
+}
+
+// sub literals : to[i] = lits[i] + to[i+neg_offset]
+//	same rules as newlzf_copy32_to_end ; neg_offset <= -32
+static RADFORCEINLINE void newlzf_literals_sub32_to_end(U8 * to, SINTa neg_offset, const U8 * lits, U8 * to_end)
+{
+	RR_ASSERT( rrPtrDiff(to_end - to) >= 32 );
+	RR_ASSERT( neg_offset <= -32 );
+	const U8 * lits_end = lits + rrPtrDiff(to_end - to);
+	while ( rrPtrDiff(to_end - to) > 32 )
+	{
+		__m256i l = _mm256_loadu_si256((const __m256i *)lits);
+		__m256i m = _mm256_loadu_si256((const __m256i *)(to + neg_offset));
+		_mm256_storeu_si256((__m256i *)to,_mm256_add_epi8(l,m));
+		to += 32;
+		lits += 32;
+	}
+	to = to_end-32;
+	lits = lits_end-32;
+	__m256i l = _mm256_loadu_si256((const __m256i *)lits);
+	__m256i m = _mm256_loadu_si256((const __m256i *)(to + neg_offset));
+	_mm256_storeu_si256((__m256i *)to,_mm256_add_epi8(l,m));
+}
+
+#undef NEWLZF_DECODE_COPY32
+#define NEWLZF_DECODE_COPY32	1
+
+#include "newlzf_simple_packets_sse4.inl"
+
+#define NEWLZF_SIXTEEN_SIMPLE_PACKETS	NEWLZF_SIXTEEN_SIMPLE_PACKETS_SSE4
+#define NEWLZF_FOUR_SIMPLE_PACKETS		NEWLZF_FOUR_SIMPLE_PACKETS_SSE4
+
+//=======================================================================
+
+#define NEWLZF_DECODE_FIRST_CHUNK 0
+#define NEWLZF_FIRST_CHUNK_FUZZ(expr)
+
+#define NEWLZF_DECODE_LITERALS_TYPE	NEWLZ_LITERALS_TYPE_SUB
+#define newLZF_decode_parse newLZF_decode_parse_sub_avx2
+
+#include "newlzf_decode_parse_outer.inl"
+
+#undef NEWLZF_DECODE_LITERALS_TYPE
+#undef newLZF_decode_parse
+
+#define NEWLZF_DECODE_LITERALS_TYPE	NEWLZ_LITERALS_TYPE_RAW
+#define newLZF_decode_parse newLZF_decode_parse_raw_avx2
+
+#include "newlzf_decode_parse_outer.inl"
+
+#undef NEWLZF_DECODE_LITERALS_TYPE
+#undef newLZF_decode_parse
+
+#undef NEWLZF_DECODE_FIRST_CHUNK
+#undef NEWLZF_FIRST_CHUNK_FUZZ
+#define NEWLZF_DECODE_FIRST_CHUNK 1
+#define NEWLZF_FIRST_CHUNK_FUZZ(expr)	REQUIRE_FUZZ_RETURN( expr , NULL )
+
+#define NEWLZF_DECODE_LITERALS_TYPE	NEWLZ_LITERALS_TYPE_SUB
+#define newLZF_decode_parse newLZF_decode_parse_sub_avx2_first
+
+#include "newlzf_decode_parse_outer.inl"
+
+#undef NEWLZF_DECODE_LITERALS_TYPE
+#undef newLZF_decode_parse
+
+#define NEWLZF_DECODE_LITERALS_TYPE	NEWLZ_LITERALS_TYPE_RAW
+#define newLZF_decode_parse newLZF_decode_parse_raw_avx2_first
+
+#include "newlzf_decode_parse_outer.inl"
+
+#undef NEWLZF_DECODE_LITERALS_TYPE
+#undef newLZF_decode_parse
+
+#undef NEWLZF_FIRST_CHUNK_FUZZ
+#undef NEWLZF_DECODE_FIRST_CHUNK
+
+//==================================================================================================
+#endif // DO_BUILD_AVX2
+
+
+OODLE_NS_END
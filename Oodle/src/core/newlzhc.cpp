@@ -29,6 +29,7 @@
 #include "newlz_complexliterals.h"
 #include "newlz_vtable.h"
 #include "newlz_arrays.inl"
+#include "newlz_arrays_huff.h"
 #include "newlz_offsets.h"
 #include "newlzhc_decoder.h"
 
@@ -871,6 +872,9 @@ typedef CTMF<U32,2,0,NEWLZHC_MML_NORMAL>	newLZHC_CTMF_Fast;
 typedef CTMF<U32,1,0,NEWLZHC_MML_NORMAL>	newLZHC_CTMF_VeryFast;
 typedef CTMF<U32,0,0,NEWLZHC_MML_NORMAL>	newLZHC_CTMF_SuperFast;
 
+// bytes ahead the lazy heuristic parsers prefetch CTMF rows (see newlz.cpp)
+#define NEWLZHC_CTMF_PREFETCH_AHEAD	4
+
 //=======================================================================================
 
 template<typename newLZHC_CTMF>
@@ -1227,6 +1231,11 @@ static SINTa newLZHC_encode_chunk(const newlz_vtable * vtable,
 			if ( rrPtrDiff(parse_end_ptr - ptr) <= (SINTa)step )
 				goto parse_chunk_done;
 
+			// get_match prefetches the next step ; also start on the row a few steps ahead
+			//	(only when stepping 1 byte at a time ; with literal skipping it's a loss)
+			if ( t_do_lazy_parse && rrPtrDiff(parse_end_ptr - ptr) > NEWLZHC_CTMF_PREFETCH_AHEAD )
+				ctmf->prefetch_rows(ptr + NEWLZHC_CTMF_PREFETCH_AHEAD);
+
 			if ( newLZHC_get_match_heuristic_inline(&chosen,ctmf,step,lastoffsets,ptr,ptr_matchend,mml,literals_start,dictionarySize,pOptions) )
 				break;
 
@@ -1464,6 +1473,15 @@ static SINTa newLZHC_put_parse(
 	const OodleSpeedFit * speedfit = vtable->speedfit;
 	*pJ = LAGRANGE_COST_INVALID;
 	
+	// huff tables sent so far in this chunk ; must track what the decoder adds in phase1
+	newlz_huff_table_cache huff_cache_storage;
+	newlz_huff_table_cache * huff_cache = NULL;
+	if ( entropy_flags & NEWLZ_ARRAY_FLAG_ALLOW_HUFF_REUSE )
+	{
+		newlz_huff_table_cache_init(&huff_cache_storage);
+		huff_cache = &huff_cache_storage;
+	}
+	
 	/*
 	// forbid edge case of zero packets :
 	if ( parsevec.empty() )
@@ -1823,6 +1841,7 @@ static SINTa newLZHC_put_parse(
 	//	to mean non-sub huffman'ed, or just straight U8 uncompressed
 	
 	SINTa literal_comp_len = -1;
+	U8 * literals_comp_ptr = comp_ptr;
 		
 	if ( literal_count < NEWLZ_HUFF_ARRAY_MIN_SIZE )
 	{
@@ -2276,6 +2295,10 @@ static SINTa newLZHC_put_parse(
 		//rrprintfvar(literal_comp_len);
 	}
 	
+	// only the single array literal types are seen by the decoder's huff_cache :
+	if ( huff_cache && *pchunktype <= NEWLZ_LITERALS_TYPE_RAW )
+		newlz_huff_table_cache_add_array(huff_cache,literals_comp_ptr,comp_ptr);
+	
 	RR_ASSERT( literals_J <= literals_uncompressed_J );
 	RR_ASSERT( literals_J >= literal_comp_len );
 	RR_ASSERT( lambda > 0.f || literals_J == literal_comp_len );
@@ -2401,7 +2424,7 @@ static SINTa newLZHC_put_parse(
 		rrPrintf_v2("NEWLZHC put packets : ");
 			
 		packet_comp_len = newLZ_put_array(comp_ptr,comp_end,packets_array,packet_count,
-			entropy_flags,lambda,speedfit,&packet_J,ARRAY_DEADLINE_HUGE,arena,level,NULL);
+			entropy_flags,lambda,speedfit,&packet_J,ARRAY_DEADLINE_HUGE,arena,level,NULL,huff_cache);
 		
 		rrPrintf_v2("%d -> %d\n",packet_count,packet_comp_len);
 	}
@@ -2964,6 +2987,11 @@ static SINTa newLZHC_decode_chunk_phase1(
 	//---------------------------------------------
 	// unpack the huff arrays of literals & packets :
 	
+	// huff tables seen in this chunk, for arrays that reuse them
+	//	only single array literals & simple packets take part
+	newlz_huff_table_cache huff_cache;
+	newlz_huff_table_cache_init(&huff_cache);
+	
 	SINTa tot_literals_count;
 		
 	{
@@ -2985,7 +3013,7 @@ static SINTa newLZHC_decode_chunk_phase1(
 			SINTa literals_comp_len = newLZ_get_array(&literals,comp_ptr,chunk_comp_end,&literals_count,
 										RR_MIN(chunk_len,rrPtrDiff(scratch_end-scratch_ptr)),
 										force_copy_uncompressed,
-										scratch_ptr,scratch_end);
+										scratch_ptr,scratch_end,&huff_cache);
 			if ( literals_comp_len < 0 ) return -1;		
 						
 			comp_ptr += literals_comp_len;
@@ -3076,7 +3104,7 @@ static SINTa newLZHC_decode_chunk_phase1(
 		SINTa packets_comp_len = newLZ_get_array(&packets,comp_ptr,chunk_comp_end,&tot_packets_count,
 			RR_MIN(max_packets_count,rrPtrDiff(scratch_end-scratch_ptr)),
 			force_copy_uncompressed,
-			scratch_ptr,scratch_end);
+			scratch_ptr,scratch_end,&huff_cache);
 			
 		if ( packets_comp_len < 0 ) return -1;
 		
@@ -6740,6 +6768,7 @@ static SINTa newLZHC_encode_chunk_optimal_tll(const newlz_vtable * vtable,
 
 OODLE_NS_END
 #include "suffixtrie.h"
+#include "suffixarray.h"
 OODLE_NS_START
 
 #endif // OODLE_PLATFORM_HAS_ADVANCED_MATCHERS
@@ -6782,6 +6811,12 @@ void Leviathan_FillVTable(
 	vtable.entropy_flags |= NEWLZ_ARRAY_FLAG_ALLOW_SPLIT | NEWLZ_ARRAY_FLAG_ALLOW_SPLIT_INDEXED;
 	vtable.entropy_flags |= NEWLZ_ARRAY_FLAG_ALLOW_HUFFLENS2;
 	vtable.entropy_flags |= NEWLZ_ARRAY_FLAG_ALLOW_RLE_MEMSET;
+	
+	// rANS arrays & huff table reuse are opt-in ; only when the caller says old decoders don't matter :
+	if ( g_OodleLZ_BackwardsCompatible_MajorVersion >= NEWLZ_RANS_MIN_MAJOR_VERSION )
+		vtable.entropy_flags |= NEWLZ_ARRAY_FLAG_ALLOW_RANS;
+	if ( g_OodleLZ_BackwardsCompatible_MajorVersion >= NEWLZ_HUFF_REUSE_MIN_MAJOR_VERSION )
+		vtable.entropy_flags |= NEWLZ_ARRAY_FLAG_ALLOW_HUFF_REUSE;
 		
 	// newlzhc doesn't test this, but set it anyway :
 	vtable.bitstream_flags = NEWLZ_BITSTREAM_FLAG_ALT_OFFSETS;
@@ -6798,6 +6833,8 @@ void Leviathan_FillVTable(
 		vtable.entropy_flags &= ~NEWLZ_ARRAY_FLAG_ALLOW_SPLIT;
 	if ( level <= OodleLZ_CompressionLevel_SuperFast )
 		vtable.entropy_flags &= ~NEWLZ_ARRAY_FLAG_ALLOW_TANS;
+	if ( level < OodleLZ_CompressionLevel_Optimal1 )
+		vtable.entropy_flags &= ~NEWLZ_ARRAY_FLAG_ALLOW_RANS;
 		
 	//-----------------------------------------------------
 	// set up newLZ "vtable" :
@@ -6827,7 +6864,15 @@ void Leviathan_FillVTable(
 	else if ( level >= OodleLZ_CompressionLevel_Optimal2 )
 	{
 		vtable.fp_encode_chunk = newLZHC_encode_chunk_optimal_tll;
-		vtable.fp_create_match_finder = SuffixTrie_CreateMatchFinder;
+		if ( pOptions->suffixArrayMatchFinder )
+		{
+			vtable.fp_create_match_finder = SuffixArray_CreateMatchFinder;
+			vtable.fp_create_match_finder_runs_jobs = SuffixArray_CreateRunsJobs;
+		}
+		else
+		{
+			vtable.fp_create_match_finder = SuffixTrie_CreateMatchFinder;
+		}
 		vtable.find_all_matches_num_pairs = NEWLZHC_MATCH_NUM_PAIRS;
 		vtable.wants_dic_limit_splits = true;
 	}
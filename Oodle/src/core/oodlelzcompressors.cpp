@@ -28,6 +28,7 @@
 #include "newlzhc.h"
 #include "newlzf.h"
 #include "lzb.h"
+#include "longrangematcher.h"
 
 #include "newlz_arrays.h" // for NEWLZ_ARRAY_INTERNAL_MAX_SCRATCH
 #include "newlz_shared.h" // for NEWLZ_CHUNK_LEN
@@ -1949,6 +1950,37 @@ OOFUNC1 SINTa OOFUNC2 OodleLZ_GetInPlaceDecodeBufferSize(OodleLZ_Compressor comp
 	}
 }
 
+OOFUNC1 SINTa OOFUNC2 OodleLZ_DecompressInPlace(void * buf,SINTa bufSize,
+	SINTa compOffset,SINTa compLen,SINTa rawLen,
+	OodleLZ_FuzzSafe fuzzSafe RADDEFAULT(OodleLZ_FuzzSafe_Yes),
+	OodleLZ_CheckCRC checkCRC RADDEFAULT(OodleLZ_CheckCRC_No))
+{
+	OOFUNCSTART
+
+	if ( buf == NULL || compLen <= 0 || rawLen <= 0 ||
+		compOffset < 0 || compOffset > bufSize - compLen )
+		return OODLELZ_FAILED;
+
+	U8 * bufPtr = U8_void(buf);
+
+	OodleLZ_Compressor compressor = OodleLZ_GetAllChunksCompressor(bufPtr + compOffset,compLen,rawLen);
+	if ( compressor == OodleLZ_Compressor_Invalid )
+		return OODLELZ_FAILED;
+
+	if ( bufSize < OodleLZ_GetInPlaceDecodeBufferSize(compressor,compLen,rawLen) )
+	{
+		ooLogError("OodleLZ_DecompressInPlace: bufSize is less than OodleLZ_GetInPlaceDecodeBufferSize\n");
+		return OODLELZ_FAILED;
+	}
+
+	// the decoder writes the front while reading ahead of it ; the comp must end at the end of buf :
+	U8 * compPtr = bufPtr + bufSize - compLen;
+	if ( bufPtr + compOffset != compPtr )
+		memmove(compPtr,bufPtr + compOffset,compLen);
+
+	return OodleLZ_Decompress(compPtr,compLen,bufPtr,rawLen,fuzzSafe,checkCRC,OodleLZ_Verbosity_None);
+}
+
 
 SINTa OodleLZ_CompressMemcpy_DecodeType(int decodeType,const U8 * rawBuf,SINTa rawLen,U8 * compBuf,const U8 * dicBase,const OodleLZ_CompressOptions * pOptions)
 {
@@ -3044,6 +3076,8 @@ OOFUNC1 SINTa OOFUNC2 OodleLZ_Compress(OodleLZ_Compressor compressor,
 			arena_allocSizeIfNoneGiven = RR_MIN( rawLen*8 + 16384 , (1<<20) );
 		rrPrintf_v2("arena_allocSizeIfNoneGiven : %d\n",(int)arena_allocSizeIfNoneGiven);
 		arena_alloc = OodleMalloc(arena_allocSizeIfNoneGiven);
+		// the bound covers the CTMF hash table, which is most of the arena :
+		OodleMemoryHint(arena_alloc,arena_allocSizeIfNoneGiven,OODLE_MEMORY_HINT_LARGE_RANDOM_ACCESS);
 		scratchMem  = arena_alloc;
 		scratchSize = arena_allocSizeIfNoneGiven;
 		// this is totally wasted for the old compressors, but whatevs
@@ -3058,6 +3092,19 @@ OOFUNC1 SINTa OOFUNC2 OodleLZ_Compress(OodleLZ_Compressor compressor,
 	
 	rrArenaAllocator arena(scratchMem,scratchSize,true);
 	const LRMCascade * lrmc = (const LRMCascade *)lrmv;
+	
+	#if OODLE_PLATFORM_HAS_ADVANCED_MATCHERS
+	// the encoder lines up LRM chunks with the local window, so the LRM has to be
+	//	made on this dictionaryBase with this maxLocalDictionarySize
+	if ( lrmc != NULL &&
+		( pOptions->seekChunkReset ||
+		  LRM_GetCascadeBuffer(lrmc) != dictionaryBase ||
+		  LRM_GetCascadeChunkSize(lrmc) != pOptions->maxLocalDictionarySize/2 ) )
+	{
+		ooLogUsageWarning2("lrm does not match dictionaryBase / maxLocalDictionarySize (or seekChunkReset is on); ignoring it\n",0);
+		lrmc = NULL;
+	}
+	#endif
 			
 	SINTa totCompLen;
 	
@@ -3213,6 +3260,1405 @@ OOFUNC1 SINTa OOFUNC2 OodleLZ_Compress(OodleLZ_Compressor compressor,
 	return totCompLen;
 }
 
+//===================================================================
+
+OOFUNC1 void * OOFUNC2 OodleLZ_CreateLRM(const void * buf,SINTa bufLen,
+	const OodleLZ_CompressOptions * pOptions RADDEFAULT(NULL))
+{
+	OOFUNCSTART
+	
+	#if OODLE_PLATFORM_HAS_ADVANCED_MATCHERS
+	
+	OodleCore_Enter();
+	
+	struct OodleLZ_CompressOptions local_options_copy;
+	pOptions = OodleLZ_CompressOptions_GetDefault_Or_Copy_And_Validate(pOptions,&local_options_copy);
+	
+	if ( buf == NULL || bufLen < 0 )
+		return NULL;
+	
+	// same chunking newlz_compress_vtable uses for its own cascade :
+	SINTa chunkSize = pOptions->maxLocalDictionarySize/2;
+	SINTa fillLen = (bufLen / chunkSize) * chunkSize;
+	
+	LRMCascade * casc;
+	if ( pOptions->jobify != OodleLZ_Jobify_Disable && Oodle_IsJobSystemSet() )
+		casc = LRM_CreateCascadeJobified(VU8(buf),fillLen,g_OodleLZ_LW_LRM_step,g_OodleLZ_LW_LRM_jumpbits,0,chunkSize,g_OodleLZ_LW_LRM_hashLength,pOptions->jobifyUserPtr);
+	else
+		casc = LRM_CreateCascade(VU8(buf),fillLen,g_OodleLZ_LW_LRM_step,g_OodleLZ_LW_LRM_jumpbits,0,chunkSize,g_OodleLZ_LW_LRM_hashLength);
+	
+	return casc;
+	
+	#else
+	
+	RR_UNUSED_VARIABLE(buf);
+	RR_UNUSED_VARIABLE(bufLen);
+	RR_UNUSED_VARIABLE(pOptions);
+	return NULL;
+	
+	#endif
+}
+
+OOFUNC1 rrbool OOFUNC2 OodleLZ_ExtendLRM(void * lrm,const void * buf,SINTa bufLen)
+{
+	OOFUNCSTART
+	
+	#if OODLE_PLATFORM_HAS_ADVANCED_MATCHERS
+	
+	LRMCascade * casc = (LRMCascade *)lrm;
+	if ( casc == NULL || LRM_GetCascadeBuffer(casc) != VU8(buf) )
+		return false;
+	
+	// never shrinks :
+	LRM_ExtendCascade(casc,bufLen);
+	return true;
+	
+	#else
+	
+	RR_UNUSED_VARIABLE(lrm);
+	RR_UNUSED_VARIABLE(buf);
+	RR_UNUSED_VARIABLE(bufLen);
+	return false;
+	
+	#endif
+}
+
+OOFUNC1 void OOFUNC2 OodleLZ_FreeLRM(void * lrm)
+{
+	OOFUNCSTART
+	
+	#if OODLE_PLATFORM_HAS_ADVANCED_MATCHERS
+	if ( lrm )
+		LRM_DestroyCascade((LRMCascade *)lrm);
+	#else
+	RR_UNUSED_VARIABLE(lrm);
+	#endif
+}
+
+//===================================================================
+// patch compression :
+//
+//	the reference and the new data are laid out contiguously as
+//	[ zero pad | reference tail | raw ]
+//	so the stream is just a normal dictionary-backup compress
+//	pad puts raw on an OODLELZ_BLOCK_LEN boundary, as the decoder needs
+//	it's derived from refLen alone so DecompressPatch can rebuild the same layout
+
+static SINTa OodleLZ_Patch_UsedRefLen(SINTa refLen)
+{
+	return RR_MIN(refLen,(SINTa)OODLELZ_PATCH_MAX_REFERENCE);
+}
+
+static SINTa OodleLZ_Patch_Pad(SINTa usedRefLen)
+{
+	return (-usedRefLen) & (OODLELZ_BLOCK_LEN-1);
+}
+
+struct OodleLZ_PatchReference
+{
+	U8 *	buf;		// [ pad | ref | maxRawLen ]
+	SINTa	rawPos;		// pad + usedRefLen
+	SINTa	maxRawLen;
+	OodleLZ_CompressOptions options;
+	#if OODLE_PLATFORM_HAS_ADVANCED_MATCHERS
+	LRMCascade * casc;	// over [0,rawPos) ; extended over raw on each compress ; may be NULL
+	#endif
+};
+
+OOFUNC1 OodleLZ_PatchReference * OOFUNC2 OodleLZ_PatchReference_Create(const void * refBuf,SINTa refLen,
+	SINTa maxRawLen,const OodleLZ_CompressOptions * pOptions RADDEFAULT(NULL))
+{
+	OOFUNCSTART
+	
+	OodleCore_Enter();
+	
+	if ( refBuf == NULL || refLen < 0 || maxRawLen <= 0 )
+		return NULL;
+	
+	struct OodleLZ_CompressOptions local_options_copy;
+	pOptions = OodleLZ_CompressOptions_GetDefault_Or_Copy_And_Validate(pOptions,&local_options_copy);
+	
+	if ( pOptions->seekChunkReset )
+	{
+		ooLogError("OodleLZ_PatchReference_Create: seekChunkReset would cut off the reference\n");
+		return NULL;
+	}
+	
+	SINTa usedRefLen = OodleLZ_Patch_UsedRefLen(refLen);
+	SINTa pad = OodleLZ_Patch_Pad(usedRefLen);
+	SINTa rawPos = pad + usedRefLen;
+	
+	OodleLZ_PatchReference * ref = (OodleLZ_PatchReference *) OodleMalloc(sizeof(OodleLZ_PatchReference));
+	ref->buf = (U8 *) OodleMalloc(rawPos + maxRawLen);
+	ref->rawPos = rawPos;
+	ref->maxRawLen = maxRawLen;
+	ref->options = *pOptions;
+	
+	memset(ref->buf,0,pad);
+	memcpy(ref->buf+pad,(const U8 *)refBuf + refLen - usedRefLen,usedRefLen);
+	
+	#if OODLE_PLATFORM_HAS_ADVANCED_MATCHERS
+	// the compressor only looks at the LRM when the window doesn't cover everything :
+	ref->casc = NULL;
+	if ( rawPos + maxRawLen > ref->options.maxLocalDictionarySize )
+		ref->casc = (LRMCascade *) OodleLZ_CreateLRM(ref->buf,rawPos,&ref->options);
+	#endif
+	
+	return ref;
+}
+
+OOFUNC1 void OOFUNC2 OodleLZ_PatchReference_Free(OodleLZ_PatchReference * ref)
+{
+	OOFUNCSTART
+	
+	if ( ref == NULL )
+		return;
+	
+	#if OODLE_PLATFORM_HAS_ADVANCED_MATCHERS
+	OodleLZ_FreeLRM(ref->casc);
+	#endif
+	
+	OodleFree(ref->buf);
+	OodleFree(ref);
+}
+
+OOFUNC1 SINTa OOFUNC2 OodleLZ_CompressPatch(OodleLZ_Compressor compressor,
+	const void * rawBuf,SINTa rawLen,void * compBuf,
+	OodleLZ_CompressionLevel level,
+	OodleLZ_PatchReference * ref)
+{
+	OOFUNCSTART
+	
+	if ( ref == NULL || rawBuf == NULL || rawLen <= 0 )
+		return OODLELZ_FAILED;
+	
+	if ( rawLen > ref->maxRawLen )
+	{
+		ooLogError("OodleLZ_CompressPatch: rawLen is bigger than the maxRawLen of the reference\n");
+		return OODLELZ_FAILED;
+	}
+	
+	U8 * raw = ref->buf + ref->rawPos;
+	memcpy(raw,rawBuf,rawLen);
+	
+	const void * lrm = NULL;
+	
+	#if OODLE_PLATFORM_HAS_ADVANCED_MATCHERS
+	if ( ref->casc != NULL && level >= OodleLZ_CompressionLevel_Optimal1 )
+	{
+		// drop whatever a previous call hashed of its raw data, then index ours :
+		LRM_TruncateCascade(ref->casc,ref->rawPos);
+		LRM_ExtendCascade(ref->casc,ref->rawPos + rawLen);
+		lrm = ref->casc;
+	}
+	#endif
+	
+	return OodleLZ_Compress(compressor,raw,rawLen,compBuf,level,&ref->options,ref->buf,lrm);
+}
+
+OOFUNC1 SINTa OOFUNC2 OodleLZ_GetPatchDecodePad(SINTa refLen)
+{
+	OOFUNCSTART
+	
+	if ( refLen < 0 )
+		return 0;
+	
+	return OodleLZ_Patch_Pad(OodleLZ_Patch_UsedRefLen(refLen));
+}
+
+OOFUNC1 SINTa OOFUNC2 OodleLZ_DecompressPatchInPlace(const void * compBuf,SINTa compBufSize,
+	void * patchBuf,SINTa refLen,SINTa rawLen,
+	OodleLZ_FuzzSafe fuzzSafe RADDEFAULT(OodleLZ_FuzzSafe_Yes),
+	OodleLZ_CheckCRC checkCRC RADDEFAULT(OodleLZ_CheckCRC_No))
+{
+	OOFUNCSTART
+	
+	if ( compBuf == NULL || patchBuf == NULL || rawLen <= 0 || refLen < 0 )
+		return OODLELZ_FAILED;
+	
+	SINTa usedRefLen = OodleLZ_Patch_UsedRefLen(refLen);
+	SINTa pad = OodleLZ_Patch_Pad(usedRefLen);
+	
+	// patchBuf is [ pad | ref | raw ] ; pad is only non-zero when all of ref is used
+	RR_ASSERT( pad == 0 || usedRefLen == refLen );
+	U8 * raw = (U8 *)patchBuf + pad + refLen;
+	U8 * base = raw - usedRefLen - pad;
+	SINTa totLen = pad + usedRefLen + rawLen;
+	
+	memset(base,0,pad);
+	
+	// Decompress with a decBufBase returns the end pos, which includes the backup :
+	SINTa ret = OodleLZ_Decompress(compBuf,compBufSize,raw,rawLen,fuzzSafe,checkCRC,
+		OodleLZ_Verbosity_None,base,totLen);
+	
+	return ( ret == totLen ) ? rawLen : OODLELZ_FAILED;
+}
+
+OOFUNC1 SINTa OOFUNC2 OodleLZ_DecompressPatch(const void * compBuf,SINTa compBufSize,
+	void * rawBuf,SINTa rawLen,
+	const void * refBuf,SINTa refLen,
+	OodleLZ_FuzzSafe fuzzSafe RADDEFAULT(OodleLZ_FuzzSafe_Yes),
+	OodleLZ_CheckCRC checkCRC RADDEFAULT(OodleLZ_CheckCRC_No))
+{
+	OOFUNCSTART
+	
+	if ( compBuf == NULL || rawBuf == NULL || rawLen <= 0 || refLen < 0 || ( refBuf == NULL && refLen > 0 ) )
+		return OODLELZ_FAILED;
+	
+	SINTa usedRefLen = OodleLZ_Patch_UsedRefLen(refLen);
+	SINTa pad = OodleLZ_Patch_Pad(usedRefLen);
+	
+	U8 * buf = (U8 *) OodleMalloc(pad + usedRefLen + rawLen);
+	memcpy(buf+pad,(const U8 *)refBuf + refLen - usedRefLen,usedRefLen);
+	
+	SINTa ret = OodleLZ_DecompressPatchInPlace(compBuf,compBufSize,buf,usedRefLen,rawLen,fuzzSafe,checkCRC);
+	
+	if ( ret == rawLen )
+		memcpy(rawBuf,buf+pad+usedRefLen,rawLen);
+	
+	OodleFree(buf);
+	
+	return ret;
+}
+
+//===================================================================
+
+// copy the len raw bytes in front of segments[segI] to "to" :
+static void OodleLZ_Segments_Gather(U8 * to,const OodleLZ_DecodeSegment * segments,S32 segI,SINTa len)
+{
+	U8 * to_end = to + len;
+	while ( len > 0 )
+	{
+		RR_ASSERT( segI > 0 );
+		segI--;
+		SINTa take = RR_MIN(len,segments[segI].len);
+		to_end -= take;
+		memcpy(to_end,(const U8 *)segments[segI].ptr + segments[segI].len - take,take);
+		len -= take;
+	}
+	RR_ASSERT( to_end == to );
+}
+
+// decode rawLen bytes at compPtr and step it past them :
+static bool OodleLZ_Segments_DecodeStep(const U8 ** pCompPtr,const U8 * compEnd,
+	U8 * rawBuf,SINTa rawLen,SINTa rawPos,
+	U8 * decBufBase,
+	OodleLZ_FuzzSafe fuzzSafe,OodleLZ_CheckCRC checkCRC)
+{
+	const U8 * compPtr = *pCompPtr;
+	SINTa compAvail = rrPtrDiff(compEnd - compPtr);
+
+	// Decompress with a decBufBase returns the end pos, which includes the backup :
+	SINTa backup = decBufBase ? rrPtrDiff(rawBuf - decBufBase) : 0;
+	SINTa ret = OodleLZ_Decompress(compPtr,compAvail,rawBuf,rawLen,fuzzSafe,checkCRC,
+		OodleLZ_Verbosity_None,decBufBase,decBufBase ? backup + rawLen : 0);
+	if ( ret != backup + rawLen )
+		return false;
+
+	SINTa endPos = 0;
+	SINTa step = OodleLZ_GetCompressedStepForRawStep(compPtr,compAvail,rawPos,rawLen,&endPos,NULL);
+	if ( step <= 0 || step > compAvail || endPos != rawPos + rawLen )
+		return false;
+
+	*pCompPtr = compPtr + step;
+	return true;
+}
+
+OOFUNC1 SINTa OOFUNC2 OodleLZ_DecompressSegments(const void * compBuf,SINTa compBufSize,
+	const OodleLZ_DecodeSegment * segments,S32 numSegments,
+	S32 dictionarySize,
+	OodleLZ_FuzzSafe fuzzSafe RADDEFAULT(OodleLZ_FuzzSafe_Yes),
+	OodleLZ_CheckCRC checkCRC RADDEFAULT(OodleLZ_CheckCRC_No))
+{
+	OOFUNCSTART
+	
+	if ( compBuf == NULL || compBufSize <= 0 || segments == NULL || numSegments <= 0 )
+		return OODLELZ_FAILED;
+	
+	SINTa rawLen = 0;
+	for(S32 segI=0;segI<numSegments;segI++)
+	{
+		SINTa len = segments[segI].len;
+		if ( segments[segI].ptr == NULL || len <= 0 )
+			return OODLELZ_FAILED;
+		if ( segI < numSegments-1 && (len % OODLELZ_BLOCK_LEN) != 0 )
+			return OODLELZ_FAILED;
+		rawLen += len;
+	}
+	
+	if ( dictionarySize <= 0 )
+	{
+		// matches can go anywhere ; decode to one buffer and scatter
+		U8 * buf = (U8 *) OodleMalloc(rawLen);
+		SINTa ret = OodleLZ_Decompress(compBuf,compBufSize,buf,rawLen,fuzzSafe,checkCRC);
+		if ( ret == rawLen )
+		{
+			const U8 * from = buf;
+			for(S32 segI=0;segI<numSegments;segI++)
+			{
+				memcpy(segments[segI].ptr,from,segments[segI].len);
+				from += segments[segI].len;
+			}
+		}
+		else
+		{
+			ret = OODLELZ_FAILED;
+		}
+		OodleFree(buf);
+		return ret;
+	}
+	
+	// only the first dictLen bytes of a segment can reach back into earlier segments
+	//	(rounded up so the decBufBase backup stays a multiple of OODLELZ_BLOCK_LEN)
+	SINTa dictLen = rrAlignUpA((SINTa)dictionarySize,OODLELZ_BLOCK_LEN);
+	// nothing reaches back further than the stream ; keeps a big dictionarySize from sizing scratch
+	dictLen = RR_MIN(dictLen,rrAlignUpA(rawLen,OODLELZ_BLOCK_LEN));
+	
+	// scratch is [history | head] :
+	U8 * scratch = NULL;
+	
+	const U8 * compPtr = (const U8 *)compBuf;
+	const U8 * compEnd = compPtr + compBufSize;
+	SINTa rawPos = 0;
+	SINTa ret = rawLen;
+	
+	for(S32 segI=0;segI<numSegments;segI++)
+	{
+		U8 * segPtr = (U8 *) segments[segI].ptr;
+		SINTa segLen = segments[segI].len;
+		
+		OO_BOOL independent = false;
+		if ( OodleLZ_GetFirstChunkCompressor(compPtr,rrPtrDiff(compEnd - compPtr),&independent) == OodleLZ_Compressor_Invalid )
+		{
+			ret = OODLELZ_FAILED;
+			break;
+		}
+		
+		SINTa headLen = 0;
+		if ( ! independent && rawPos > 0 )
+		{
+			headLen = RR_MIN(dictLen,segLen);
+			SINTa histLen = RR_MIN(dictLen,rawPos);
+			
+			if ( scratch == NULL )
+				scratch = (U8 *) OodleMalloc(2*dictLen);
+			
+			OodleLZ_Segments_Gather(scratch,segments,segI,histLen);
+			
+			if ( ! OodleLZ_Segments_DecodeStep(&compPtr,compEnd,scratch+histLen,headLen,rawPos,scratch,fuzzSafe,checkCRC) )
+			{
+				ret = OODLELZ_FAILED;
+				break;
+			}
+			
+			memcpy(segPtr,scratch+histLen,headLen);
+		}
+		
+		if ( segLen > headLen )
+		{
+			// the rest of the segment only reaches back into itself :
+			if ( ! OodleLZ_Segments_DecodeStep(&compPtr,compEnd,segPtr+headLen,segLen-headLen,rawPos+headLen,
+					headLen ? segPtr : NULL,fuzzSafe,checkCRC) )
+			{
+				ret = OODLELZ_FAILED;
+				break;
+			}
+		}
+		
+		rawPos += segLen;
+	}
+	
+	if ( scratch )
+		OodleFree(scratch);
+	
+	return ret;
+}
+
+//===================================================================
+
+// Phase1 of this many blocks can be in flight while the caller runs Phase2 :
+#define OODLELZ_THREADPHASED_SLOTS_NORMAL		4
+#define OODLELZ_THREADPHASED_SLOTS_AGGRESSIVE	8
+
+struct OodleLZ_ThreadPhased_Block
+{
+	const U8 * comp;
+	SINTa compLen;
+	SINTa rawPos;		// of this block, in decBufBase
+	SINTa rawLen;		// of this block
+	U8 * decBufBase;
+	SINTa decBufSize;
+	void * decoderMemory;
+	SINTa decoderMemorySize;
+	OodleLZ_FuzzSafe fuzzSafe;
+	OodleLZ_CheckCRC checkCRC;
+	bool phase1_ok;
+	OodleJob job;
+};
+
+static bool OodleLZ_ThreadPhased_DecodeBlock(OodleLZ_ThreadPhased_Block * block,OodleLZ_Decode_ThreadPhase threadPhase)
+{
+	// Decompress with a decBufBase returns the end pos :
+	SINTa ret = OodleLZ_Decompress(block->comp,block->compLen,
+		block->decBufBase + block->rawPos,block->rawLen,
+		block->fuzzSafe,block->checkCRC,OodleLZ_Verbosity_None,
+		block->decBufBase,block->decBufSize,NULL,NULL,
+		block->decoderMemory,block->decoderMemorySize,threadPhase);
+	return ret == block->rawPos + block->rawLen;
+}
+
+static void OODLE_CALLBACK OodleLZ_ThreadPhased_Phase1Job(void * job_data)
+{
+	OodleLZ_ThreadPhased_Block * block = static_cast<OodleLZ_ThreadPhased_Block *>(job_data);
+	THREADPROFILESCOPE("ThreadPhase1");
+
+	block->phase1_ok = OodleLZ_ThreadPhased_DecodeBlock(block,OodleLZ_Decode_ThreadPhase1);
+}
+
+OOFUNC1 SINTa OOFUNC2 OodleLZ_DecompressThreadPhased(const void * compBuf,SINTa compBufSize,
+	void * rawBuf,SINTa rawLen,
+	OodleLZ_FuzzSafe fuzzSafe RADDEFAULT(OodleLZ_FuzzSafe_Yes),
+	OodleLZ_CheckCRC checkCRC RADDEFAULT(OodleLZ_CheckCRC_No),
+	OodleLZ_Jobify jobify RADDEFAULT(OodleLZ_Jobify_Default),
+	void * jobifyUserPtr RADDEFAULT(NULL))
+{
+	OOFUNCSTART
+
+	if ( compBuf == NULL || compBufSize <= 0 || rawBuf == NULL || rawLen <= 0 )
+		return OODLELZ_FAILED;
+
+	const U8 * compPtr = (const U8 *)compBuf;
+	const U8 * compEnd = compPtr + compBufSize;
+	U8 * rawPtr = (U8 *)rawBuf;
+
+	// in-place layouts would need Phase1 of later blocks to stay behind Phase2 ; just don't
+	bool overlap = compPtr < rawPtr + rawLen && rawPtr < compEnd;
+
+	OodleLZ_Compressor compressor = OodleLZ_GetAllChunksCompressor(compBuf,compBufSize,rawLen);
+
+	if ( jobify == OodleLZ_Jobify_Disable || ! Oodle_IsJobSystemSet() ||
+		rawLen <= OODLELZ_BLOCK_LEN || overlap ||
+		! OodleLZ_Compressor_CanDecodeThreadPhased(compressor) )
+	{
+		return OodleLZ_Decompress(compBuf,compBufSize,rawBuf,rawLen,fuzzSafe,checkCRC,OodleLZ_Verbosity_None);
+	}
+
+	SINTa numBlocks = (rawLen + OODLELZ_BLOCK_LEN-1) / OODLELZ_BLOCK_LEN;
+	SINTa numSlots = ( jobify == OodleLZ_Jobify_Aggressive ) ? OODLELZ_THREADPHASED_SLOTS_AGGRESSIVE : OODLELZ_THREADPHASED_SLOTS_NORMAL;
+	numSlots = RR_MIN(numSlots,numBlocks);
+
+	SINTa slotMemSize = OodleLZ_ThreadPhased_BlockDecoderMemorySizeNeeded();
+	U8 * slotMem = (U8 *) OodleMalloc(numSlots * slotMemSize);
+	OodleLZ_ThreadPhased_Block slots[OODLELZ_THREADPHASED_SLOTS_AGGRESSIVE];
+
+	for(SINTa slotI=0;slotI<numSlots;slotI++)
+	{
+		slots[slotI].decBufBase = rawPtr;
+		slots[slotI].decBufSize = rawLen;
+		slots[slotI].decoderMemory = slotMem + slotI * slotMemSize;
+		slots[slotI].decoderMemorySize = slotMemSize;
+		slots[slotI].fuzzSafe = fuzzSafe;
+		slots[slotI].checkCRC = checkCRC;
+	}
+
+	// blocks are started in order ; Phase1 of block (i+numSlots) goes in the slot block i just left
+	SINTa startedBlocks = 0;
+	SINTa ret = rawLen;
+
+	for(SINTa blockI=0;blockI<numBlocks;blockI++)
+	{
+		// top up the Phase1 jobs :
+		while ( ret != OODLELZ_FAILED && startedBlocks < numBlocks && startedBlocks < blockI + numSlots )
+		{
+			OodleLZ_ThreadPhased_Block * block = &slots[startedBlocks % numSlots];
+			block->comp = compPtr;
+			block->rawPos = startedBlocks * OODLELZ_BLOCK_LEN;
+			block->rawLen = RR_MIN(OODLELZ_BLOCK_LEN,rawLen - block->rawPos);
+
+			SINTa compAvail = rrPtrDiff(compEnd - compPtr);
+			SINTa endPos = 0;
+			block->compLen = OodleLZ_GetCompressedStepForRawStep(compPtr,compAvail,block->rawPos,block->rawLen,&endPos,NULL);
+			if ( block->compLen <= 0 || block->compLen > compAvail || endPos != block->rawPos + block->rawLen )
+			{
+				ret = OODLELZ_FAILED;
+				break;
+			}
+			compPtr += block->compLen;
+
+			block->phase1_ok = false;
+			block->job.run(OodleLZ_ThreadPhased_Phase1Job,block,jobifyUserPtr,true);
+			startedBlocks++;
+		}
+
+		if ( blockI >= startedBlocks )
+			break;
+
+		OodleLZ_ThreadPhased_Block * block = &slots[blockI % numSlots];
+		block->job.wait(jobifyUserPtr);
+
+		if ( ret == OODLELZ_FAILED )
+			continue; // still have to wait out the rest
+
+		if ( ! block->phase1_ok ||
+			! OodleLZ_ThreadPhased_DecodeBlock(block,OodleLZ_Decode_ThreadPhase2) )
+		{
+			ret = OODLELZ_FAILED;
+		}
+	}
+
+	OodleFree(slotMem);
+
+	return ret;
+}
+
+//===================================================================
+
+/**
+
+Read-ahead for compressed input in a memory mapping :
+
+the decoder reads compBuf front to back, so when compBuf is a cold file mapping every 4 KB page is
+a synchronous fault on the decoding thread.  OodleLZ_ReadAhead keeps the next _window_ bytes past the
+read position advised with OODLE_MEMORY_HINT_WILL_READ (MADV_WILLNEED by default), so the IO is queued
+well before the decoder gets there.
+
+It's re-advised when the read position has moved half a window, so it's a couple of calls per window,
+not one per block.
+
+**/
+
+#define OODLELZ_READAHEAD_DEFAULT_BYTES	(8*1024*1024)
+
+struct OodleLZ_ReadAhead
+{
+	const U8 * compEnd;
+	const U8 * hintEnd;	// advised up to here
+	SINTa window;		// 0 for no read-ahead
+};
+
+static void OodleLZ_ReadAhead_Init(OodleLZ_ReadAhead * ra,const U8 * comp,SINTa compLen,SINTa window)
+{
+	ra->compEnd = comp + compLen;
+	ra->hintEnd = comp;
+	ra->window = window;
+}
+
+static void OodleLZ_ReadAhead_Advance(OodleLZ_ReadAhead * ra,const U8 * pos)
+{
+	if ( ra->window <= 0 )
+		return;
+
+	const U8 * want = pos + RR_MIN(ra->window,rrPtrDiff(ra->compEnd - pos));
+	if ( want <= ra->hintEnd )
+		return;
+	if ( want < ra->compEnd && rrPtrDiff(want - ra->hintEnd) < ra->window/2 )
+		return;
+
+	const U8 * start = RR_MAX(pos,ra->hintEnd);
+	OodleMemoryHintWillRead(start,rrPtrDiff(want - start));
+	ra->hintEnd = want;
+}
+
+static OodleDecompressCallbackRet OODLE_CALLBACK OodleLZ_ReadAhead_Callback(void * userdata,
+	const U8 * rawBuf,SINTa rawLen,const U8 * compBuf,SINTa compBufferSize,SINTa rawDone,SINTa compUsed)
+{
+	RR_UNUSED_VARIABLE(rawBuf);
+	RR_UNUSED_VARIABLE(rawLen);
+	RR_UNUSED_VARIABLE(compBufferSize);
+	RR_UNUSED_VARIABLE(rawDone);
+
+	OodleLZ_ReadAhead_Advance((OodleLZ_ReadAhead *)userdata,compBuf + compUsed);
+	return OodleDecompressCallbackRet_Continue;
+}
+
+// plain OodleLZ_Decompress, advancing the read-ahead after each block
+static SINTa OodleLZ_ReadAhead_Decompress(const void * compBuf,SINTa compBufSize,void * rawBuf,SINTa rawLen,
+	OodleLZ_FuzzSafe fuzzSafe,OodleLZ_CheckCRC checkCRC,SINTa window)
+{
+	if ( window <= 0 )
+		return OodleLZ_Decompress(compBuf,compBufSize,rawBuf,rawLen,fuzzSafe,checkCRC,OodleLZ_Verbosity_None);
+
+	OodleLZ_ReadAhead ra;
+	OodleLZ_ReadAhead_Init(&ra,(const U8 *)compBuf,compBufSize,window);
+	OodleLZ_ReadAhead_Advance(&ra,(const U8 *)compBuf);
+
+	return OodleLZ_Decompress(compBuf,compBufSize,rawBuf,rawLen,fuzzSafe,checkCRC,OodleLZ_Verbosity_None,
+		NULL,0,OodleLZ_ReadAhead_Callback,&ra);
+}
+
+// seek chunks in flight at once :
+#define OODLELZ_SEEKCHUNKS_JOBS_NORMAL		8
+#define OODLELZ_SEEKCHUNKS_JOBS_AGGRESSIVE	32
+
+struct OodleLZ_SeekChunk_Job
+{
+	const U8 * comp;
+	SINTa compLen;
+	U8 * raw;
+	SINTa rawLen;
+	OodleLZ_FuzzSafe fuzzSafe;
+	OodleLZ_CheckCRC checkCRC;
+	bool ok;
+	OodleJob job;
+};
+
+static void OODLE_CALLBACK OodleLZ_SeekChunk_DecodeJob(void * job_data)
+{
+	OodleLZ_SeekChunk_Job * chunk = static_cast<OodleLZ_SeekChunk_Job *>(job_data);
+	THREADPROFILESCOPE("SeekChunk");
+
+	SINTa ret = OodleLZ_Decompress(chunk->comp,chunk->compLen,chunk->raw,chunk->rawLen,
+		chunk->fuzzSafe,chunk->checkCRC,OodleLZ_Verbosity_None);
+	chunk->ok = ( ret == chunk->rawLen );
+}
+
+// readAhead = 0 for none
+static SINTa OodleLZ_DecompressSeekChunks_Sub(const void * compBuf,SINTa compBufSize,
+	void * rawBuf,SINTa rawLen,
+	OodleLZ_FuzzSafe fuzzSafe,OodleLZ_CheckCRC checkCRC,
+	OodleLZ_Jobify jobify,void * jobifyUserPtr,
+	SINTa readAhead)
+{
+	if ( compBuf == NULL || compBufSize <= 0 || rawBuf == NULL || rawLen <= 0 )
+		return OODLELZ_FAILED;
+
+	const U8 * compPtr = (const U8 *)compBuf;
+	const U8 * compEnd = compPtr + compBufSize;
+	U8 * rawPtr = (U8 *)rawBuf;
+
+	// in-place layouts would have a chunk write over the comp of a later one that's being decoded
+	bool overlap = compPtr < rawPtr + rawLen && rawPtr < compEnd;
+
+	if ( jobify == OodleLZ_Jobify_Disable || ! Oodle_IsJobSystemSet() ||
+		rawLen <= OODLELZ_BLOCK_LEN || overlap )
+	{
+		return OodleLZ_ReadAhead_Decompress(compBuf,compBufSize,rawBuf,rawLen,fuzzSafe,checkCRC,readAhead);
+	}
+
+	SINTa numSlots = ( jobify == OodleLZ_Jobify_Aggressive ) ? OODLELZ_SEEKCHUNKS_JOBS_AGGRESSIVE : OODLELZ_SEEKCHUNKS_JOBS_NORMAL;
+	OodleLZ_SeekChunk_Job slots[OODLELZ_SEEKCHUNKS_JOBS_AGGRESSIVE];
+
+	// the caller steps the block headers ahead of the jobs, so read-ahead from its position covers them
+	OodleLZ_ReadAhead ra;
+	OodleLZ_ReadAhead_Init(&ra,compPtr,compBufSize,readAhead);
+
+	SINTa rawPos = 0;
+	SINTa started = 0;
+	SINTa ret = rawLen;
+
+	while ( rawPos < rawLen )
+	{
+		// step blocks up to the next independent one :
+		const U8 * chunkComp = compPtr;
+		SINTa chunkRawPos = rawPos;
+		for(;;)
+		{
+			OodleLZ_ReadAhead_Advance(&ra,compPtr);
+
+			SINTa compAvail = rrPtrDiff(compEnd - compPtr);
+			SINTa blockLen = RR_MIN(OODLELZ_BLOCK_LEN,rawLen - rawPos);
+			SINTa endPos = 0;
+			SINTa step = OodleLZ_GetCompressedStepForRawStep(compPtr,compAvail,rawPos,blockLen,&endPos,NULL);
+			if ( step <= 0 || step > compAvail || endPos != rawPos + blockLen )
+			{
+				ret = OODLELZ_FAILED;
+				break;
+			}
+			compPtr += step;
+			rawPos += blockLen;
+
+			if ( rawPos == rawLen )
+				break;
+
+			OO_BOOL independent = false;
+			if ( OodleLZ_GetFirstChunkCompressor(compPtr,rrPtrDiff(compEnd - compPtr),&independent) == OodleLZ_Compressor_Invalid )
+			{
+				ret = OODLELZ_FAILED;
+				break;
+			}
+			if ( independent )
+				break;
+		}
+
+		if ( ret == OODLELZ_FAILED )
+			break;
+
+		if ( chunkRawPos == 0 && rawPos == rawLen )
+		{
+			// no seek resets ; nothing to run in parallel
+			return OodleLZ_ReadAhead_Decompress(compBuf,compBufSize,rawBuf,rawLen,fuzzSafe,checkCRC,readAhead);
+		}
+
+		OodleLZ_SeekChunk_Job * chunk = &slots[started % numSlots];
+		if ( started >= numSlots )
+		{
+			chunk->job.wait(jobifyUserPtr);
+			if ( ! chunk->ok )
+			{
+				ret = OODLELZ_FAILED;
+				break;
+			}
+		}
+
+		chunk->comp = chunkComp;
+		chunk->compLen = rrPtrDiff(compPtr - chunkComp);
+		chunk->raw = rawPtr + chunkRawPos;
+		chunk->rawLen = rawPos - chunkRawPos;
+		chunk->fuzzSafe = fuzzSafe;
+		chunk->checkCRC = checkCRC;
+		chunk->ok = false;
+		chunk->job.run(OodleLZ_SeekChunk_DecodeJob,chunk,jobifyUserPtr,true);
+		started++;
+	}
+
+	SINTa numUsed = RR_MIN(numSlots,started);
+	for(SINTa slotI=0;slotI<numUsed;slotI++)
+	{
+		slots[slotI].job.wait(jobifyUserPtr);
+		if ( ! slots[slotI].ok )
+			ret = OODLELZ_FAILED;
+	}
+
+	return ret;
+}
+
+OOFUNC1 SINTa OOFUNC2 OodleLZ_DecompressSeekChunks(const void * compBuf,SINTa compBufSize,
+	void * rawBuf,SINTa rawLen,
+	OodleLZ_FuzzSafe fuzzSafe RADDEFAULT(OodleLZ_FuzzSafe_Yes),
+	OodleLZ_CheckCRC checkCRC RADDEFAULT(OodleLZ_CheckCRC_No),
+	OodleLZ_Jobify jobify RADDEFAULT(OodleLZ_Jobify_Default),
+	void * jobifyUserPtr RADDEFAULT(NULL))
+{
+	OOFUNCSTART
+
+	return OodleLZ_DecompressSeekChunks_Sub(compBuf,compBufSize,rawBuf,rawLen,fuzzSafe,checkCRC,jobify,jobifyUserPtr,0);
+}
+
+OOFUNC1 SINTa OOFUNC2 OodleLZ_DecompressReadAhead(const void * compBuf,SINTa compBufSize,
+	void * rawBuf,SINTa rawLen,
+	SINTa readAheadBytes RADDEFAULT(0),
+	OodleLZ_FuzzSafe fuzzSafe RADDEFAULT(OodleLZ_FuzzSafe_Yes),
+	OodleLZ_CheckCRC checkCRC RADDEFAULT(OodleLZ_CheckCRC_No),
+	OodleLZ_Jobify jobify RADDEFAULT(OodleLZ_Jobify_Default),
+	void * jobifyUserPtr RADDEFAULT(NULL))
+{
+	OOFUNCSTART
+
+	if ( readAheadBytes <= 0 )
+		readAheadBytes = OODLELZ_READAHEAD_DEFAULT_BYTES;
+
+	return OodleLZ_DecompressSeekChunks_Sub(compBuf,compBufSize,rawBuf,rawLen,fuzzSafe,checkCRC,jobify,jobifyUserPtr,readAheadBytes);
+}
+
+//===================================================================
+
+// independent seek chunks checked at once :
+#define OODLELZ_VERIFY_JOBS_NORMAL		8
+#define OODLELZ_VERIFY_JOBS_AGGRESSIVE	32
+
+// decode one seek chunk to [decBufBase+histLen,+rawLen) and check its raw CRC
+static bool OodleLZ_Verify_DecodeChunk(const U8 * comp,SINTa compLen,
+	U8 * decBufBase,SINTa histLen,SINTa rawLen,const U32 * pRawCRC,
+	OodleLZ_FuzzSafe fuzzSafe,OodleLZ_CheckCRC checkCRC)
+{
+	// Decompress with a decBufBase returns the end pos, which includes the history :
+	SINTa ret = OodleLZ_Decompress(comp,compLen,decBufBase + histLen,rawLen,
+		fuzzSafe,checkCRC,OodleLZ_Verbosity_None,
+		histLen ? decBufBase : NULL,histLen ? histLen + rawLen : 0);
+	if ( ret != ( histLen ? histLen + rawLen : rawLen ) )
+		return false;
+
+	if ( pRawCRC && rrLZH_CRC_Block(decBufBase + histLen,rawLen) != *pRawCRC )
+		return false;
+
+	return true;
+}
+
+struct OodleLZ_Verify_Job
+{
+	const U8 * comp;
+	SINTa compLen;
+	U8 * buf;			// seekChunkLen bytes owned by the slot
+	SINTa rawLen;
+	const U32 * pRawCRC;
+	S32 seekI;
+	OodleLZ_FuzzSafe fuzzSafe;
+	OodleLZ_CheckCRC checkCRC;
+	bool ok;
+	OodleJob job;
+};
+
+static void OODLE_CALLBACK OodleLZ_Verify_ChunkJob(void * job_data)
+{
+	OodleLZ_Verify_Job * chunk = static_cast<OodleLZ_Verify_Job *>(job_data);
+	THREADPROFILESCOPE("VerifyChunk");
+
+	chunk->ok = OodleLZ_Verify_DecodeChunk(chunk->comp,chunk->compLen,chunk->buf,0,chunk->rawLen,
+		chunk->pRawCRC,chunk->fuzzSafe,chunk->checkCRC);
+}
+
+OOFUNC1 S32 OOFUNC2 OodleLZ_Verify(const void * compBuf,SINTa compBufSize,
+	const OodleLZ_SeekTable * seekTable,
+	S32 dictionarySize,
+	U8 * chunkFailed RADDEFAULT(NULL),
+	OodleLZ_FuzzSafe fuzzSafe RADDEFAULT(OodleLZ_FuzzSafe_Yes),
+	OodleLZ_CheckCRC checkCRC RADDEFAULT(OodleLZ_CheckCRC_No),
+	OodleLZ_Jobify jobify RADDEFAULT(OodleLZ_Jobify_Default),
+	void * jobifyUserPtr RADDEFAULT(NULL))
+{
+	OOFUNCSTART
+
+	if ( compBuf == NULL || seekTable == NULL || seekTable->numSeekChunks <= 0 ||
+		seekTable->totalRawLen <= 0 || compBufSize < seekTable->totalCompLen )
+		return -1;
+
+	S32 numSeekChunks = seekTable->numSeekChunks;
+	SINTa seekChunkLen = seekTable->seekChunkLen;
+	SINTa rawLen = (SINTa) seekTable->totalRawLen;
+	if ( seekChunkLen <= 0 || (seekChunkLen % OODLELZ_BLOCK_LEN) != 0 ||
+		OodleLZ_GetNumSeekChunks(rawLen,(S32)seekChunkLen) != numSeekChunks )
+		return -1;
+
+	if ( chunkFailed )
+		memset(chunkFailed,0,numSeekChunks);
+
+	const U8 * compPtr = (const U8 *)compBuf;
+	S32 numFailed = 0;
+
+	if ( seekTable->seekChunksIndependent && jobify != OodleLZ_Jobify_Disable && Oodle_IsJobSystemSet() && numSeekChunks > 1 )
+	{
+		SINTa numSlots = ( jobify == OodleLZ_Jobify_Aggressive ) ? OODLELZ_VERIFY_JOBS_AGGRESSIVE : OODLELZ_VERIFY_JOBS_NORMAL;
+		numSlots = RR_MIN(numSlots,(SINTa)numSeekChunks);
+
+		U8 * slotBufs = (U8 *) OodleMalloc(numSlots * seekChunkLen);
+		OodleLZ_Verify_Job slots[OODLELZ_VERIFY_JOBS_AGGRESSIVE];
+
+		// chunk seekI goes in slot (seekI % numSlots) once the chunk before it in that slot is done
+		for(S32 seekI=0;seekI<numSeekChunks+numSlots;seekI++)
+		{
+			OodleLZ_Verify_Job * chunk = &slots[seekI % numSlots];
+			if ( seekI >= numSlots )
+			{
+				chunk->job.wait(jobifyUserPtr);
+				if ( ! chunk->ok )
+				{
+					numFailed++;
+					if ( chunkFailed )
+						chunkFailed[chunk->seekI] = 1;
+				}
+			}
+
+			if ( seekI >= numSeekChunks )
+				continue;
+
+			chunk->comp = compPtr;
+			chunk->compLen = seekTable->seekChunkCompLens[seekI];
+			chunk->buf = slotBufs + (seekI % numSlots) * seekChunkLen;
+			chunk->rawLen = RR_MIN(seekChunkLen,rawLen - seekI * seekChunkLen);
+			chunk->pRawCRC = seekTable->rawCRCs ? seekTable->rawCRCs + seekI : NULL;
+			chunk->seekI = seekI;
+			chunk->fuzzSafe = fuzzSafe;
+			chunk->checkCRC = checkCRC;
+			chunk->ok = false;
+			chunk->job.run(OodleLZ_Verify_ChunkJob,chunk,jobifyUserPtr,true);
+
+			compPtr += chunk->compLen;
+		}
+
+		OodleFree(slotBufs);
+
+		return numFailed;
+	}
+
+	// serial : the window is [history | chunk]
+	//	history is the last histLen bytes decoded, kept as a multiple of OODLELZ_BLOCK_LEN for decBufBase
+	SINTa histMax = 0;
+	if ( ! seekTable->seekChunksIndependent )
+	{
+		histMax = ( dictionarySize <= 0 ) ? rawLen : rrAlignUpA((SINTa)dictionarySize,OODLELZ_BLOCK_LEN);
+		histMax = RR_MIN(histMax,rrAlignUpA(rawLen,OODLELZ_BLOCK_LEN));
+	}
+
+	// slide at most every histMax bytes so the memmove is amortized
+	SINTa bufSize = RR_MIN( histMax + RR_MAX(histMax,seekChunkLen) , rrAlignUpA(rawLen,OODLELZ_BLOCK_LEN) );
+	U8 * buf = (U8 *) OodleMalloc(bufSize);
+
+	SINTa bufPos = 0;
+
+	for(S32 seekI=0;seekI<numSeekChunks;seekI++)
+	{
+		SINTa chunkLen = RR_MIN(seekChunkLen,rawLen - seekI * seekChunkLen);
+
+		if ( histMax == 0 )
+		{
+			bufPos = 0;
+		}
+		else if ( bufPos + chunkLen > bufSize )
+		{
+			memmove(buf,buf + bufPos - histMax,histMax);
+			bufPos = histMax;
+		}
+
+		SINTa compLen = seekTable->seekChunkCompLens[seekI];
+		const U32 * pRawCRC = seekTable->rawCRCs ? seekTable->rawCRCs + seekI : NULL;
+
+		if ( ! OodleLZ_Verify_DecodeChunk(compPtr,compLen,buf,bufPos,chunkLen,pRawCRC,fuzzSafe,checkCRC) )
+		{
+			// keep going ; a bad chunk leaves bad history, so later dependent chunks will fail their CRC too
+			numFailed++;
+			if ( chunkFailed )
+				chunkFailed[seekI] = 1;
+		}
+
+		compPtr += compLen;
+		bufPos += chunkLen;
+	}
+
+	OodleFree(buf);
+
+	return numFailed;
+}
+
+//===================================================================
+
+/**
+
+Headerless quanta :
+
+a headerless quantum is the payload of one NewLZ block with the LZBlockHeader and LZLargeQuantumHeader
+stripped ; the container stores rawLen, compLen and the reset flag instead.
+
+	compLen == rawLen : stored uncompressed (memcpy block, or a quantum that didn't compress)
+	compLen == 1 : memset quantum, the byte is the value
+	otherwise : the quantum as Kraken/Mermaid/Leviathan_DecodeOneQuantum reads it
+
+A normal quantum always has at least one 3-byte chunk header, so compLen == 1 can't be one.
+(NewLZ never sends wholematch quanta.)
+
+Quanta are grouped into runs that start at a reset ; runs are independent, so they're the unit of jobs.
+
+**/
+
+// runs of quanta in flight at once :
+#define OODLELZ_HEADERLESS_JOBS_NORMAL		8
+#define OODLELZ_HEADERLESS_JOBS_AGGRESSIVE	32
+
+static bool OodleLZ_Headerless_CheckArgs(OodleLZ_Compressor compressor,
+	const S32 * quantumRawLens,const rrbool * quantumIsReset,S32 numQuanta)
+{
+	// Hydra could switch decoder per block, which a headerless quantum has no room to say
+	if ( ! OodleLZ_Compressor_IsNewLZFamily(compressor) || compressor == OodleLZ_Compressor_Hydra )
+	{
+		ooLogError("OodleLZ Headerless Quanta : compressor must be Kraken, Mermaid, Selkie or Leviathan\n");
+		return false;
+	}
+
+	if ( quantumRawLens == NULL || numQuanta <= 0 )
+		return false;
+
+	for(S32 qI=0;qI<numQuanta;qI++)
+	{
+		if ( quantumRawLens[qI] <= 0 || quantumRawLens[qI] > OODLELZ_BLOCK_LEN )
+			return false;
+
+		// dictionary backup must be a multiple of OODLELZ_BLOCK_LEN :
+		if ( qI+1 < numQuanta && quantumIsReset && ! quantumIsReset[qI+1] &&
+			quantumRawLens[qI] != OODLELZ_BLOCK_LEN )
+		{
+			ooLogError("OodleLZ Headerless Quanta : a quantum followed by a non-reset quantum must be OODLELZ_BLOCK_LEN\n");
+			return false;
+		}
+	}
+
+	return true;
+}
+
+// a run of quanta from a reset up to the next one :
+struct OodleLZ_Headerless_Run
+{
+	OodleLZ_Compressor compressor;
+	const S32 * rawLens;
+	S32 * compLens;		// written by encode, read by decode
+	S32 numQuanta;
+	U8 * raw;
+	U8 * comp;
+	SINTa compLen;		// of the run ; encode output, decode input
+	// encode :
+	OodleLZ_CompressionLevel level;
+	const OodleLZ_CompressOptions * pOptions;
+	void * scratch;		// decode : decoder scratch
+	SINTa scratchSize;
+	bool ok;
+	OodleJob job;
+};
+
+// run->comp has room for the raw length of the run ; a quantum never comes out bigger than its raw
+//	the run is compressed with one OodleLZ_Compress ; every quantum but the last is OODLELZ_BLOCK_LEN,
+//	so its blocks are the quanta, and the headers are stripped block by block
+static bool OodleLZ_Headerless_EncodeRun(OodleLZ_Headerless_Run * run)
+{
+	SINTa runRawLen = 0;
+	for(S32 qI=0;qI<run->numQuanta;qI++)
+		runRawLen += run->rawLens[qI];
+
+	SINTa runCompSize = OodleLZ_GetCompressedBufferSizeNeeded(run->compressor,runRawLen);
+	U8 * runComp = (U8 *) OodleMalloc(runCompSize);
+
+	SINTa runCompLen = OodleLZ_Compress(run->compressor,run->raw,runRawLen,runComp,run->level,run->pOptions);
+
+	bool ok = runCompLen > 0;
+	const U8 * ptr = runComp;
+	const U8 * runCompEnd = runComp + runCompLen;
+	U8 * compPtr = run->comp;
+	const U8 * rawPtr = run->raw;
+
+	for(S32 qI=0;ok && qI<run->numQuanta;qI++)
+	{
+		SINTa rawLen = run->rawLens[qI];
+
+		// strip the headers :
+		LZBlockHeader header;
+		ptr = LZBlockHeader_Get(&header,ptr);
+		if ( ptr == NULL )
+		{
+			ok = false;
+			break;
+		}
+
+		SINTa compLen = rawLen;
+		if ( header.chunkIsMemcpy )
+		{
+			ptr += rawLen;
+		}
+		else
+		{
+			LZQuantumHeader qh;
+			int qhLen = LZLargeQuantumHeader_Get(ptr,runCompEnd,&qh,header.chunkHasQuantumCRCs,(S32)rawLen);
+			if ( qhLen < 0 || qh.wholeMatchFlag )
+			{
+				ok = false;
+				break;
+			}
+			ptr += qhLen;
+
+			if ( qh.compLen == 0 )
+			{
+				*compPtr = (U8) qh.crc;
+				compLen = 1;
+			}
+			else if ( qh.compLen > 1 && qh.compLen < rawLen )
+			{
+				memcpy(compPtr,ptr,qh.compLen);
+				compLen = qh.compLen;
+			}
+			ptr += qh.compLen;
+		}
+
+		if ( ptr > runCompEnd )
+		{
+			ok = false;
+			break;
+		}
+
+		if ( compLen == rawLen )
+			memcpy(compPtr,rawPtr,rawLen);
+
+		run->compLens[qI] = (S32) compLen;
+		compPtr += compLen;
+		rawPtr += rawLen;
+	}
+
+	RR_ASSERT( ! ok || ptr == runCompEnd );
+
+	OodleFree(runComp);
+
+	run->compLen = rrPtrDiff(compPtr - run->comp);
+	return ok;
+}
+
+static bool OodleLZ_Headerless_DecodeRun(const OodleLZ_Headerless_Run * run)
+{
+	const U8 * compPtr = run->comp;
+	const U8 * compEnd = compPtr + run->compLen;
+	U8 * rawPtr = run->raw;
+	SINTa pos_since_reset = 0;
+
+	for(S32 qI=0;qI<run->numQuanta;qI++)
+	{
+		SINTa rawLen = run->rawLens[qI];
+		SINTa compLen = run->compLens[qI];
+		if ( compLen <= 0 || compLen > rawLen || compLen > rrPtrDiff(compEnd - compPtr) )
+			return false;
+
+		if ( compLen == rawLen )
+		{
+			memcpy(rawPtr,compPtr,rawLen);
+		}
+		else if ( compLen == 1 )
+		{
+			memset(rawPtr,*compPtr,rawLen);
+		}
+		else
+		{
+			S32 gotCompLen;
+			if ( run->compressor == OodleLZ_Compressor_Kraken )
+				gotCompLen = Kraken_DecodeOneQuantum(rawPtr,rawPtr+rawLen,compPtr,(S32)compLen,compPtr+compLen,pos_since_reset,run->scratch,run->scratchSize,OodleLZ_Decode_Unthreaded);
+			else if ( run->compressor == OodleLZ_Compressor_Leviathan )
+				gotCompLen = Leviathan_DecodeOneQuantum(rawPtr,rawPtr+rawLen,compPtr,(S32)compLen,compPtr+compLen,pos_since_reset,run->scratch,run->scratchSize,OodleLZ_Decode_Unthreaded);
+			else // Mermaid & Selkie
+				gotCompLen = Mermaid_DecodeOneQuantum(rawPtr,rawPtr+rawLen,compPtr,(S32)compLen,compPtr+compLen,pos_since_reset,run->scratch,run->scratchSize,OodleLZ_Decode_Unthreaded);
+
+			if ( gotCompLen != compLen )
+				return false;
+		}
+
+		compPtr += compLen;
+		rawPtr += rawLen;
+		pos_since_reset += rawLen;
+	}
+
+	return true;
+}
+
+static void OODLE_CALLBACK OodleLZ_Headerless_EncodeJob(void * job_data)
+{
+	OodleLZ_Headerless_Run * run = static_cast<OodleLZ_Headerless_Run *>(job_data);
+	THREADPROFILESCOPE("HeaderlessEncode");
+
+	run->ok = OodleLZ_Headerless_EncodeRun(run);
+}
+
+static void OODLE_CALLBACK OodleLZ_Headerless_DecodeJob(void * job_data)
+{
+	OodleLZ_Headerless_Run * run = static_cast<OodleLZ_Headerless_Run *>(job_data);
+	THREADPROFILESCOPE("HeaderlessDecode");
+
+	run->ok = OodleLZ_Headerless_DecodeRun(run);
+}
+
+// number of quanta in the run starting at firstI :
+static S32 OodleLZ_Headerless_RunLen(const rrbool * quantumIsReset,S32 firstI,S32 numQuanta)
+{
+	if ( quantumIsReset == NULL )
+		return 1;
+
+	S32 endI = firstI+1;
+	while ( endI < numQuanta && ! quantumIsReset[endI] )
+		endI++;
+	return endI - firstI;
+}
+
+OOFUNC1 SINTa OOFUNC2 OodleLZ_CompressHeaderlessQuanta(OodleLZ_Compressor compressor,
+	const void * rawBuf,const S32 * quantumRawLens,const rrbool * quantumIsReset,S32 numQuanta,
+	void * compBuf,SINTa compBufSize,S32 * quantumCompLens,
+	OodleLZ_CompressionLevel level,
+	const OodleLZ_CompressOptions * pOptions RADDEFAULT(NULL))
+{
+	OOFUNCSTART
+
+	if ( rawBuf == NULL || compBuf == NULL || quantumCompLens == NULL ||
+		! OodleLZ_Headerless_CheckArgs(compressor,quantumRawLens,quantumIsReset,numQuanta) )
+		return OODLELZ_FAILED;
+
+	SINTa rawLen = 0;
+	for(S32 qI=0;qI<numQuanta;qI++)
+		rawLen += quantumRawLens[qI];
+
+	// runs are compressed in place at their raw pos, then packed down ; needs compBufSize >= rawLen
+	if ( compBufSize < rawLen )
+		return OODLELZ_FAILED;
+
+	OodleLZ_CompressOptions options = pOptions ? *pOptions : *OodleLZ_CompressOptions_GetDefault(compressor,level);
+	options.seekChunkReset = false;
+	options.sendQuantumCRCs = false;
+
+	bool jobs = options.jobify != OodleLZ_Jobify_Disable && Oodle_IsJobSystemSet() &&
+		OodleLZ_Headerless_RunLen(quantumIsReset,0,numQuanta) < numQuanta;
+	void * jobifyUserPtr = options.jobifyUserPtr;
+
+	SINTa numSlots = 1;
+	if ( jobs )
+	{
+		numSlots = ( options.jobify == OodleLZ_Jobify_Aggressive ) ? OODLELZ_HEADERLESS_JOBS_AGGRESSIVE : OODLELZ_HEADERLESS_JOBS_NORMAL;
+		// the runs are the parallelism ; don't also spawn per-block jobs inside each one
+		options.jobify = OodleLZ_Jobify_Disable;
+	}
+
+	OodleLZ_Headerless_Run slots[OODLELZ_HEADERLESS_JOBS_AGGRESSIVE];
+
+	U8 * rawPtr = (U8 *) rawBuf;
+	U8 * compBase = (U8 *) compBuf;
+	SINTa rawPos = 0;
+	SINTa compPos = 0;
+	SINTa started = 0;
+	SINTa retired = 0;
+	bool failed = false;
+
+	for(S32 qI=0;qI<numQuanta || retired < started;)
+	{
+		// retire the oldest run when all slots are busy or there's nothing left to start :
+		if ( started - retired == numSlots || qI == numQuanta )
+		{
+			OodleLZ_Headerless_Run * run = &slots[retired % numSlots];
+			if ( jobs )
+				run->job.wait(jobifyUserPtr);
+			else
+				run->ok = OodleLZ_Headerless_EncodeRun(run);
+			retired++;
+
+			if ( ! run->ok )
+				failed = true;
+			if ( failed )
+				continue; // still have to wait out the rest
+
+			// pack it down ; compPos <= the run's raw pos, so this never reaches the next run
+			memmove(compBase + compPos,run->comp,run->compLen);
+			compPos += run->compLen;
+			continue;
+		}
+
+		if ( failed )
+		{
+			qI = numQuanta;
+			continue;
+		}
+
+		S32 runLen = OodleLZ_Headerless_RunLen(quantumIsReset,qI,numQuanta);
+
+		OodleLZ_Headerless_Run * run = &slots[started % numSlots];
+		run->compressor = compressor;
+		run->rawLens = quantumRawLens + qI;
+		run->compLens = quantumCompLens + qI;
+		run->numQuanta = runLen;
+		run->raw = rawPtr + rawPos;
+		run->comp = compBase + rawPos;
+		run->compLen = 0;
+		run->level = level;
+		run->pOptions = &options;
+		run->scratch = NULL;
+		run->scratchSize = 0;
+		run->ok = false;
+		if ( jobs )
+			run->job.run(OodleLZ_Headerless_EncodeJob,run,jobifyUserPtr,true);
+		started++;
+
+		for(S32 i=0;i<runLen;i++)
+			rawPos += quantumRawLens[qI+i];
+		qI += runLen;
+	}
+
+	if ( failed )
+		return OODLELZ_FAILED;
+
+	return compPos;
+}
+
+OOFUNC1 SINTa OOFUNC2 OodleLZ_DecompressHeaderlessQuanta(OodleLZ_Compressor compressor,
+	const void * compBuf,SINTa compBufSize,const S32 * quantumCompLens,
+	void * rawBuf,const S32 * quantumRawLens,const rrbool * quantumIsReset,S32 numQuanta,
+	OodleLZ_Jobify jobify RADDEFAULT(OodleLZ_Jobify_Default),
+	void * jobifyUserPtr RADDEFAULT(NULL))
+{
+	OOFUNCSTART
+
+	if ( compBuf == NULL || rawBuf == NULL || quantumCompLens == NULL || compBufSize <= 0 ||
+		! OodleLZ_Headerless_CheckArgs(compressor,quantumRawLens,quantumIsReset,numQuanta) )
+		return OODLELZ_FAILED;
+
+	SINTa rawLen = 0;
+	for(S32 qI=0;qI<numQuanta;qI++)
+		rawLen += quantumRawLens[qI];
+
+	const U8 * compPtr = (const U8 *)compBuf;
+	const U8 * compEnd = compPtr + compBufSize;
+	U8 * rawPtr = (U8 *)rawBuf;
+
+	if ( compPtr < rawPtr + rawLen && rawPtr < compEnd )
+	{
+		ooLogError("OodleLZ_DecompressHeaderlessQuanta : compBuf and rawBuf must not overlap\n");
+		return OODLELZ_FAILED;
+	}
+
+	bool jobs = jobify != OodleLZ_Jobify_Disable && Oodle_IsJobSystemSet() &&
+		OodleLZ_Headerless_RunLen(quantumIsReset,0,numQuanta) < numQuanta;
+
+	SINTa numSlots = 1;
+	if ( jobs )
+		numSlots = ( jobify == OodleLZ_Jobify_Aggressive ) ? OODLELZ_HEADERLESS_JOBS_AGGRESSIVE : OODLELZ_HEADERLESS_JOBS_NORMAL;
+
+	SINTa scratchSize = OodleLZ_Compressor_ScratchMemSize(compressor,OODLELZ_BLOCK_LEN);
+	U8 * slotMem = (U8 *) OodleMalloc(numSlots * scratchSize);
+	OodleLZ_Headerless_Run slots[OODLELZ_HEADERLESS_JOBS_AGGRESSIVE];
+
+	SINTa rawPos = 0;
+	SINTa started = 0;
+	SINTa retired = 0;
+	SINTa ret = rawLen;
+
+	for(S32 qI=0;qI<numQuanta || retired < started;)
+	{
+		// retire the oldest run when all slots are busy or there's nothing left to start :
+		if ( started - retired == numSlots || qI == numQuanta )
+		{
+			OodleLZ_Headerless_Run * run = &slots[retired % numSlots];
+			if ( jobs )
+				run->job.wait(jobifyUserPtr);
+			else
+				run->ok = OodleLZ_Headerless_DecodeRun(run);
+			retired++;
+
+			if ( ! run->ok )
+				ret = OODLELZ_FAILED;
+			continue;
+		}
+
+		S32 runLen = OodleLZ_Headerless_RunLen(quantumIsReset,qI,numQuanta);
+
+		SINTa runRawLen = 0;
+		SINTa runCompLen = 0;
+		for(S32 i=0;i<runLen;i++)
+		{
+			runRawLen += quantumRawLens[qI+i];
+			runCompLen += quantumCompLens[qI+i];
+		}
+
+		if ( ret == OODLELZ_FAILED || runCompLen > rrPtrDiff(compEnd - compPtr) )
+		{
+			// stop starting runs ; still have to wait out the rest
+			ret = OODLELZ_FAILED;
+			qI = numQuanta;
+			continue;
+		}
+
+		OodleLZ_Headerless_Run * run = &slots[started % numSlots];
+		run->compressor = compressor;
+		run->rawLens = quantumRawLens + qI;
+		run->compLens = const_cast<S32 *>(quantumCompLens) + qI;
+		run->numQuanta = runLen;
+		run->raw = rawPtr + rawPos;
+		run->comp = const_cast<U8 *>(compPtr);
+		run->compLen = runCompLen;
+		run->level = OodleLZ_CompressionLevel_None;
+		run->pOptions = NULL;
+		run->scratch = slotMem + (started % numSlots) * scratchSize;
+		run->scratchSize = scratchSize;
+		run->ok = false;
+		if ( jobs )
+			run->job.run(OodleLZ_Headerless_DecodeJob,run,jobifyUserPtr,true);
+		started++;
+
+		rawPos += runRawLen;
+		compPtr += runCompLen;
+		qI += runLen;
+	}
+
+	OodleFree(slotMem);
+
+	return ret;
+}
+
+//===================================================================
+
 OOFUNC1 SINTa OOFUNC2 OodleLZ_GetCompressScratchMemBound(
 	OodleLZ_Compressor compressor,
 	OodleLZ_CompressionLevel level,
@@ -3432,6 +4878,7 @@ static OodleLZ_CompressOptions s_defaultOptions =
 	NULL, // jobifyUserPtr
 	0, //farMatchMinLen
 	0, //farMatchOffsetLog2
+	false, // suffixArrayMatchFinder
 	
 	// reserved
 	// more zeros
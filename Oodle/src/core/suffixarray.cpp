@@ -0,0 +1,1043 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+// This source file is licensed solely to users who have
+// accepted a valid Unreal Engine license agreement 
+// (see e.g., https://www.unrealengine.com/eula), and use
+// of this source file is governed by such agreement.
+
+#include "suffixarray.h"
+
+#include "rrbase.h"
+#include <templates/rrvector.h>
+#include <templates/rralgorithm.h>
+#include <limits.h>
+
+#include "matchfinder.h"
+#include "longrangematcher.h"
+#include "suffixtrie.h" // after longrangematcher.h so its LRMSet is the namespaced one
+#include "cbradutil.h"
+#include "rrbits.h"
+#include "oodlejob.h"
+#include "oodlemalloc.h"
+
+#include "threadprofiler.h"
+#include "rrprefetch.h"
+#include "rrlz_getmatchlen.inl"
+
+/**
+
+SuffixArrayMatchFinder
+
+finds the same kind of match lists as SuffixTrie2MatchFinder ,
+but from a suffix array + LCP instead of growing a trie one position at a time
+
+construction :
+
+1. suffix sort
+	serially with SA-IS (Nong, Zhang, Chan)
+	with SA_MIN_JOBS_FOR_DOUBLING or more jobs, by prefix doubling (Larsson-Sadakane) instead :
+	start from buckets on the first two bytes and one round on the next three bytes of text,
+	then each round sorts every unsorted group by the rank h bytes ahead
+	groups are independent so a round is split across jobs
+	rank reads (pass 1) and rank writes (pass 2) are separate passes so the jobs never race
+
+2. LCP with the permuted LCP ("Phi") method (Karkkainen, Manzini, Puglisi)
+	the PLCP scan goes in text order, so the string compares walk memory forwards
+	it's split into text ranges ; each range restarts its running lcp at 0
+
+3. one pass over the LCP array with a stack builds the lcp-interval tree
+	internal nodes are exactly the branching nodes of the suffix tree
+	each text position records its deepest interval (leaf_parent)
+
+match finding :
+
+ProcessChunk walks from leaf_parent[pos] up to the root, like the trie walk does,
+recording (depth, pos - node.pos) and then setting node.pos = pos
+
+node.pos starts at the highest position in the subtree that's before startRecordingPos
+(or the lowest position in the subtree if there is none)
+so the dictionary is "inserted" for free, and a node that no walk has reached yet
+still holds a real occurrence when it's below pos
+
+nodes whose whole subtree is at or after pos are not previous matches and are skipped
+(each node is skipped like that at exactly one pos, so this is linear overall)
+
+the longest match is exact, shorter ones are limited by SA_LIMIT_PARENT_STEPS
+the same way ST2 uses LIMIT_PARENT_STEPS
+
+**/
+
+// like LIMIT_PARENT_STEPS in suffixtrie.cpp
+#define SA_LIMIT_PARENT_STEPS	16
+
+#define SA_PREFETCH_AHEAD		8
+
+// most jobs used for one construction step
+#define SA_MAX_JOBS			16
+// don't split less than this much work across jobs
+#define SA_MIN_JOB_SIZE		(1<<16)
+// prefix doubling does several times the work of SA-IS ; only worth it spread over this many jobs
+#define SA_MIN_JOBS_FOR_DOUBLING	4
+
+// shortest parent match we report ; the trie stops at the same place
+#define SA_MIN_PARENT_LEN	3
+
+#if OODLE_PLATFORM_HAS_ADVANCED_MATCHERS
+OODLE_NS_START
+
+//=====================================================
+
+struct SANode
+{
+	S32 depth;	// lcp of the interval
+	S32 parent;	// node 0 is the root
+	S32 pos;	// most recent position seen under this node
+};
+
+struct SAGroup
+{
+	S32 start,end; // unsorted range [start,end) of the suffix array
+};
+
+//=====================================================
+// run a function on [lo,hi) slices as jobs
+
+typedef void (t_sa_slice_func)(void * data, int job, SINTa lo, SINTa hi);
+
+struct SASliceJob
+{
+	t_sa_slice_func * func;
+	void * data;
+	int job;
+	SINTa lo,hi;
+};
+
+static void OODLE_CALLBACK sa_slice_job_shim(void * job_data)
+{
+	SASliceJob * job = static_cast<SASliceJob *>(job_data);
+	job->func(job->data,job->job,job->lo,job->hi);
+}
+
+// bounds[] has num_jobs+1 entries ; the last slice runs on the calling thread
+static void sa_run_slices(t_sa_slice_func * func, void * data, const SINTa * bounds, int num_jobs, void * jobifyUserPtr)
+{
+	RR_ASSERT( num_jobs >= 1 && num_jobs <= SA_MAX_JOBS );
+
+	SASliceJob desc[SA_MAX_JOBS];
+	OodleJob jobs[SA_MAX_JOBS];
+
+	for(int j=0;j<num_jobs;j++)
+	{
+		desc[j].func = func;
+		desc[j].data = data;
+		desc[j].job = j;
+		desc[j].lo = bounds[j];
+		desc[j].hi = bounds[j+1];
+
+		jobs[j].run(sa_slice_job_shim,&desc[j],jobifyUserPtr, j != num_jobs-1 );
+	}
+
+	for(int j=0;j<num_jobs;j++)
+		jobs[j].wait(jobifyUserPtr);
+}
+
+static void sa_even_bounds(SINTa * bounds, int num_jobs, SINTa count)
+{
+	for(int j=0;j<=num_jobs;j++)
+		bounds[j] = (SINTa)( ((S64)count * j) / num_jobs );
+}
+
+//=====================================================
+// suffix sort
+
+// 2-byte bucket key ; the end of the buffer sorts before any byte
+#define SA_NUM_BUCKETS	(257*257)
+
+// the first round sorts on this many more bytes of text , then doubling takes over
+#define SA_TEXT_KEY_BYTES	3
+
+#define SA_INSERTION_SORT_MAX	16
+
+struct SASortState
+{
+	const U8 * ubuf;
+	S32 size;
+	S32 h;
+	bool text_keys;		// first round reads the text after the bucket instead of ranks
+
+	S32 * sa;
+	S32 * rank;
+	U64 * keys;			// [rank h ahead + 1 , pos] packed for sorting
+
+	S32 * bucket_counts;	// [num_jobs][SA_NUM_BUCKETS]
+
+	const SAGroup * groups;
+	vector<SAGroup> new_groups[SA_MAX_JOBS];
+};
+
+static RADFORCEINLINE U32 sa_bucket_key(const U8 * ubuf, S32 size, S32 i)
+{
+	U32 c0 = ubuf[i] + 1;
+	U32 c1 = ( i+1 < size ) ? ubuf[i+1] + 1 : 0;
+	return c0*257 + c1;
+}
+
+static void sa_bucket_count_job(void * data, int job, SINTa lo, SINTa hi)
+{
+	SASortState * st = static_cast<SASortState *>(data);
+	S32 * counts = st->bucket_counts + (SINTa)job * SA_NUM_BUCKETS;
+
+	for(SINTa i=lo;i<hi;i++)
+		counts[ sa_bucket_key(st->ubuf,st->size,(S32)i) ]++;
+}
+
+static void sa_bucket_scatter_job(void * data, int job, SINTa lo, SINTa hi)
+{
+	SASortState * st = static_cast<SASortState *>(data);
+	// counts were turned into the first slot for this job in each bucket
+	S32 * next = st->bucket_counts + (SINTa)job * SA_NUM_BUCKETS;
+	S32 * sa = st->sa;
+
+	for(SINTa i=lo;i<hi;i++)
+		sa[ next[ sa_bucket_key(st->ubuf,st->size,(S32)i) ]++ ] = (S32)i;
+}
+
+static void sa_bucket_rank_job(void * data, int job, SINTa lo, SINTa hi)
+{
+	SASortState * st = static_cast<SASortState *>(data);
+	RR_UNUSED_VARIABLE(job);
+	// caller points bucket_counts at the end of each bucket
+	const S32 * ends = st->bucket_counts;
+
+	for(SINTa i=lo;i<hi;i++)
+		st->rank[i] = ends[ sa_bucket_key(st->ubuf,st->size,(S32)i) ] - 1;
+}
+
+// pass 1 : read the ranks h ahead for every suffix in an unsorted group
+static void sa_round_keys_job(void * data, int job, SINTa lo, SINTa hi)
+{
+	SASortState * st = static_cast<SASortState *>(data);
+	RR_UNUSED_VARIABLE(job);
+	const S32 * sa = st->sa;
+	const S32 * rank = st->rank;
+	U64 * keys = st->keys;
+	S32 size = st->size;
+	S32 h = st->h;
+
+	if ( st->text_keys )
+	{
+		// the next SA_TEXT_KEY_BYTES bytes , 9 bits each so the end sorts first
+		const U8 * ubuf = st->ubuf;
+		for(SINTa g=lo;g<hi;g++)
+		{
+			const SAGroup & grp = st->groups[g];
+			for(S32 k=grp.start;k<grp.end;k++)
+			{
+				S32 s = sa[k];
+				U32 key = 0;
+				for(int b=0;b<SA_TEXT_KEY_BYTES;b++)
+				{
+					S32 i = s + h + b;
+					key = (key<<9) | ( ( i < size ) ? ubuf[i] + 1 : 0 );
+				}
+				keys[k] = ((U64)key<<32) | (U32)s;
+			}
+		}
+		return;
+	}
+
+	for(SINTa g=lo;g<hi;g++)
+	{
+		const SAGroup & grp = st->groups[g];
+		for(S32 k=grp.start;k<grp.end;k++)
+		{
+			S32 s = sa[k];
+			U32 key = ( s + h < size ) ? (U32)(rank[s+h] + 1) : 0;
+			keys[k] = ((U64)key<<32) | (U32)s;
+		}
+	}
+}
+
+// pass 2 : sort each group by those keys and split it
+static void sa_round_sort_job(void * data, int job, SINTa lo, SINTa hi)
+{
+	SASortState * st = static_cast<SASortState *>(data);
+	S32 * sa = st->sa;
+	S32 * rank = st->rank;
+	U64 * keys = st->keys;
+	vector<SAGroup> & out = st->new_groups[job];
+
+	for(SINTa g=lo;g<hi;g++)
+	{
+		const SAGroup & grp = st->groups[g];
+		U64 * gkeys = keys + grp.start;
+		S32 count = grp.end - grp.start;
+
+		// lots of groups are tiny
+		if ( count <= SA_INSERTION_SORT_MAX )
+		{
+			for(S32 i=1;i<count;i++)
+			{
+				U64 x = gkeys[i];
+				S32 j = i;
+				while( j > 0 && gkeys[j-1] > x )
+				{
+					gkeys[j] = gkeys[j-1];
+					j--;
+				}
+				gkeys[j] = x;
+			}
+		}
+		else
+		{
+			stdsort(gkeys, gkeys + count);
+		}
+
+		S32 k = grp.start;
+		while( k < grp.end )
+		{
+			U32 key = (U32)(keys[k]>>32);
+			S32 run_end = k+1;
+			while( run_end < grp.end && (U32)(keys[run_end]>>32) == key )
+				run_end++;
+
+			// group number is the last slot of the group
+			for(S32 r=k;r<run_end;r++)
+			{
+				S32 s = (S32)(U32)keys[r];
+				sa[r] = s;
+				rank[s] = run_end-1;
+			}
+
+			if ( run_end - k > 1 )
+			{
+				SAGroup ng = { k, run_end };
+				out.push_back(ng);
+			}
+
+			k = run_end;
+		}
+	}
+}
+
+// split groups [0,num_groups) into slices of about equal suffix count
+static int sa_group_bounds(SINTa * bounds, int max_jobs, const SAGroup * groups, SINTa num_groups, SINTa total)
+{
+	int num_jobs = (int) RR_MIN( (SINTa)max_jobs, RR_MAX(total / SA_MIN_JOB_SIZE,(SINTa)1) );
+	num_jobs = (int) RR_MIN( (SINTa)num_jobs, num_groups );
+	num_jobs = RR_MAX(num_jobs,1);
+
+	bounds[0] = 0;
+	SINTa g = 0;
+	SINTa sum = 0;
+	for(int j=1;j<num_jobs;j++)
+	{
+		SINTa target = (SINTa)( ((S64)total * j) / num_jobs );
+		while( g < num_groups && sum < target )
+		{
+			sum += groups[g].end - groups[g].start;
+			g++;
+		}
+		bounds[j] = g;
+	}
+	bounds[num_jobs] = num_groups;
+
+	return num_jobs;
+}
+
+static void sa_suffix_sort(S32 * sa, S32 * rank, const U8 * ubuf, S32 size, int num_jobs, void * jobifyUserPtr)
+{
+	THREADPROFILESCOPE("SA_SuffixSort");
+
+	SASortState st;
+	st.ubuf = ubuf;
+	st.size = size;
+	st.h = 2;
+	st.text_keys = true;
+	st.sa = sa;
+	st.rank = rank;
+
+	SINTa bounds[SA_MAX_JOBS+1];
+
+	// radix sort on the first two bytes :
+	{
+		vector<S32> counts;
+		counts.resize((SINTa)num_jobs*SA_NUM_BUCKETS,0);
+		st.bucket_counts = counts.data();
+
+		sa_even_bounds(bounds,num_jobs,size);
+		sa_run_slices(sa_bucket_count_job,&st,bounds,num_jobs,jobifyUserPtr);
+
+		// turn counts into per-job start slots
+		vector<SAGroup> groups;
+		S32 total = 0;
+		for(int b=0;b<SA_NUM_BUCKETS;b++)
+		{
+			S32 bucket_start = total;
+			for(int j=0;j<num_jobs;j++)
+			{
+				S32 & c = counts[(SINTa)j*SA_NUM_BUCKETS + b];
+				S32 cnt = c;
+				c = total;
+				total += cnt;
+			}
+			if ( total - bucket_start > 1 )
+			{
+				SAGroup g = { bucket_start, total };
+				groups.push_back(g);
+			}
+		}
+		RR_ASSERT( total == size );
+
+		sa_run_slices(sa_bucket_scatter_job,&st,bounds,num_jobs,jobifyUserPtr);
+
+		// after the scatter, the last job row holds the end of each bucket
+		st.bucket_counts = counts.data() + (SINTa)(num_jobs-1)*SA_NUM_BUCKETS;
+		sa_run_slices(sa_bucket_rank_job,&st,bounds,num_jobs,jobifyUserPtr);
+
+		st.new_groups[0].swap(groups);
+	}
+
+	U64 * keys = OODLE_MALLOC_ARRAY(U64,size);
+	st.keys = keys;
+
+	vector<SAGroup> groups;
+	for(;;)
+	{
+		// gather the groups left from the last round :
+		groups.clear();
+		SINTa total = 0;
+		for(int j=0;j<SA_MAX_JOBS;j++)
+		{
+			for LOOPVEC(i,st.new_groups[j])
+			{
+				groups.push_back(st.new_groups[j][i]);
+				total += st.new_groups[j][i].end - st.new_groups[j][i].start;
+			}
+			st.new_groups[j].clear();
+		}
+
+		if ( groups.empty() )
+			break;
+
+		st.groups = groups.data();
+		int round_jobs = sa_group_bounds(bounds,num_jobs,groups.data(),groups.size(),total);
+
+		sa_run_slices(sa_round_keys_job,&st,bounds,round_jobs,jobifyUserPtr);
+		sa_run_slices(sa_round_sort_job,&st,bounds,round_jobs,jobifyUserPtr);
+
+		RR_ASSERT( st.h <= size );
+		if ( st.text_keys )
+		{
+			st.h += SA_TEXT_KEY_BYTES;
+			st.text_keys = false;
+		}
+		else
+		{
+			st.h *= 2;
+		}
+	}
+
+	OODLE_FREE_ARRAY(keys,size);
+}
+
+//=====================================================
+// SA-IS (Nong, Zhang, Chan) , serial
+
+// bkt[c] = start (or end) of each character bucket
+template <typename T>
+static void sais_get_buckets(const T * t, S32 n, S32 k, S32 * bkt, bool ends)
+{
+	for(S32 c=0;c<k;c++) bkt[c] = 0;
+	for(S32 i=0;i<n;i++) bkt[ t[i] ]++;
+	S32 sum = 0;
+	for(S32 c=0;c<k;c++)
+	{
+		sum += bkt[c];
+		bkt[c] = ends ? sum : sum - bkt[c];
+	}
+}
+
+#define SAIS_IS_S(i)	(stype[i])
+#define SAIS_IS_LMS(i)	((i) > 0 && stype[i] && !stype[(i)-1])
+
+template <typename T>
+static void sais_induce(const T * t, S32 * sa, S32 n, S32 k, S32 * bkt, const U8 * stype)
+{
+	// L types, left to right ; the virtual sentinel induces n-1 first
+	sais_get_buckets(t,n,k,bkt,false);
+	sa[ bkt[ t[n-1] ]++ ] = n-1;
+	for(S32 i=0;i<n;i++)
+	{
+		S32 j = sa[i] - 1;
+		if ( j >= 0 && ! stype[j] )
+			sa[ bkt[ t[j] ]++ ] = j;
+	}
+
+	// S types, right to left
+	sais_get_buckets(t,n,k,bkt,true);
+	for(S32 i=n-1;i>=0;i--)
+	{
+		S32 j = sa[i] - 1;
+		if ( j >= 0 && stype[j] )
+			sa[ --bkt[ t[j] ] ] = j;
+	}
+}
+
+template <typename T>
+static void sais_sort(const T * t, S32 * sa, S32 n, S32 k)
+{
+	RR_ASSERT( n >= 1 );
+	if ( n == 1 )
+	{
+		sa[0] = 0;
+		return;
+	}
+
+	vector<U8> stype_v;
+	stype_v.resize(n);
+	U8 * stype = stype_v.data();
+
+	// last char is L (it's greater than the virtual sentinel)
+	stype[n-1] = 0;
+	for(S32 i=n-2;i>=0;i--)
+		stype[i] = ( t[i] < t[i+1] || ( t[i] == t[i+1] && stype[i+1] ) ) ? 1 : 0;
+
+	vector<S32> bkt_v;
+	bkt_v.resize(k);
+	S32 * bkt = bkt_v.data();
+
+	// stage 1 : sort the LMS substrings
+	sais_get_buckets(t,n,k,bkt,true);
+	for(S32 i=0;i<n;i++) sa[i] = -1;
+	for(S32 i=1;i<n;i++)
+		if ( SAIS_IS_LMS(i) )
+			sa[ --bkt[ t[i] ] ] = i;
+
+	sais_induce(t,sa,n,k,bkt,stype);
+
+	// compact the sorted LMS substrings into sa[0,m)
+	S32 m = 0;
+	for(S32 i=0;i<n;i++)
+		if ( SAIS_IS_LMS(sa[i]) )
+			sa[m++] = sa[i];
+
+	// name them ; names go in sa[m + pos/2] (LMS positions are at least 2 apart)
+	for(S32 i=m;i<n;i++) sa[i] = -1;
+	S32 name = 0;
+	S32 prev = -1;
+	for(S32 i=0;i<m;i++)
+	{
+		S32 pos = sa[i];
+		bool diff = false;
+		for(S32 d=0;;d++)
+		{
+			if ( prev < 0 || pos+d == n || prev+d == n ||
+				t[pos+d] != t[prev+d] || stype[pos+d] != stype[prev+d] )
+			{
+				diff = true;
+				break;
+			}
+			else if ( d > 0 && ( SAIS_IS_LMS(pos+d) || SAIS_IS_LMS(prev+d) ) )
+			{
+				break;
+			}
+		}
+		if ( diff )
+		{
+			name++;
+			prev = pos;
+		}
+		sa[ m + (pos>>1) ] = name - 1;
+	}
+
+	// gather the reduced string at the end of sa
+	for(S32 i=n-1,j=n-1;i>=m;i--)
+		if ( sa[i] >= 0 )
+			sa[j--] = sa[i];
+
+	// stage 2 : sort the reduced string
+	S32 * s1 = sa + n - m;
+	S32 * sa1 = sa;
+	if ( name < m )
+	{
+		sais_sort<S32>(s1,sa1,m,name);
+	}
+	else
+	{
+		for(S32 i=0;i<m;i++)
+			sa1[ s1[i] ] = i;
+	}
+
+	// stage 3 : induce the full order from the sorted LMS suffixes
+	// s1 becomes the LMS positions in text order
+	for(S32 i=1,j=0;i<n;i++)
+		if ( SAIS_IS_LMS(i) )
+			s1[j++] = i;
+	for(S32 i=0;i<m;i++)
+		sa1[i] = s1[ sa1[i] ];
+	for(S32 i=m;i<n;i++)
+		sa[i] = -1;
+
+	sais_get_buckets(t,n,k,bkt,true);
+	for(S32 i=m-1;i>=0;i--)
+	{
+		S32 j = sa[i];
+		sa[i] = -1;
+		sa[ --bkt[ t[j] ] ] = j;
+	}
+
+	sais_induce(t,sa,n,k,bkt,stype);
+}
+
+#undef SAIS_IS_S
+#undef SAIS_IS_LMS
+
+//=====================================================
+// LCP
+
+struct SALCPState
+{
+	const U8 * ubuf;
+	S32 size;
+	const S32 * sa;
+	S32 * phi;	// becomes plcp in place
+	S32 * lcp;
+};
+
+static void sa_phi_job(void * data, int job, SINTa lo, SINTa hi)
+{
+	SALCPState * st = static_cast<SALCPState *>(data);
+	RR_UNUSED_VARIABLE(job);
+	for(SINTa r=lo;r<hi;r++)
+		st->phi[ st->sa[r] ] = ( r == 0 ) ? -1 : st->sa[r-1];
+}
+
+static void sa_plcp_job(void * data, int job, SINTa lo, SINTa hi)
+{
+	SALCPState * st = static_cast<SALCPState *>(data);
+	RR_UNUSED_VARIABLE(job);
+	const U8 * ubuf = st->ubuf;
+	const U8 * ubuf_end = ubuf + st->size;
+	S32 * phi = st->phi;
+
+	S32 h = 0;
+	for(SINTa i=lo;i<hi;i++)
+	{
+		S32 j = phi[i];
+		if ( j < 0 )
+		{
+			phi[i] = 0;
+			h = 0;
+			continue;
+		}
+
+		// only the later of the two is checked against the end
+		const U8 * p1 = ubuf + RR_MAX((S32)i,j);
+		const U8 * p2 = ubuf + RR_MIN((S32)i,j);
+		h += getmatchlen_mml1(p1+h,p2+h,ubuf_end);
+
+		phi[i] = h;
+		if ( h > 0 ) h--;
+	}
+}
+
+static void sa_lcp_job(void * data, int job, SINTa lo, SINTa hi)
+{
+	SALCPState * st = static_cast<SALCPState *>(data);
+	RR_UNUSED_VARIABLE(job);
+	for(SINTa r=lo;r<hi;r++)
+		st->lcp[r] = st->phi[ st->sa[r] ];
+}
+
+// lcp[r] = lcp of suffixes sa[r-1] and sa[r] ; lcp[0] = 0
+//	scratch is clobbered
+static void sa_compute_lcp(S32 * lcp, S32 * scratch, const S32 * sa, const U8 * ubuf, S32 size, int num_jobs, void * jobifyUserPtr)
+{
+	THREADPROFILESCOPE("SA_LCP");
+
+	SALCPState st;
+	st.ubuf = ubuf;
+	st.size = size;
+	st.sa = sa;
+	st.phi = scratch;
+	st.lcp = lcp;
+
+	SINTa bounds[SA_MAX_JOBS+1];
+	sa_even_bounds(bounds,num_jobs,size);
+
+	sa_run_slices(sa_phi_job,&st,bounds,num_jobs,jobifyUserPtr);
+	sa_run_slices(sa_plcp_job,&st,bounds,num_jobs,jobifyUserPtr);
+	sa_run_slices(sa_lcp_job,&st,bounds,num_jobs,jobifyUserPtr);
+}
+
+//=====================================================
+
+class SuffixArrayMatchFinder : public IncrementalMatchFinder
+{
+	const U8 * m_ubuf;
+	S32 m_size;
+	S32 m_pos;
+
+	SANode * m_nodes;
+	S32 m_num_nodes;
+	S32 * m_leaf_parent; // [pos] -> deepest node
+
+	bool has_lrm;
+	bool run_lrm_as_job;
+	LRMScannerWindowed scanner;
+	void * jobifyUserPtr;
+	vector<UnpackedMatchPair> lrm_matches;
+
+	void LRMJob(int chunkStart, int chunkEnd);
+	static void OODLE_CALLBACK LRMJobShim(void *job_data);
+
+	void BuildTree(const S32 * sa, const S32 * lcp, S32 startRecordingPos);
+
+public:
+	SuffixArrayMatchFinder(const U8 * ubuf, S32 size, S32 startRecordingPos, LRMSet * lrms, OodleLZ_Jobify jobify, void * jobify_userPtr);
+	~SuffixArrayMatchFinder();
+
+	int ProcessChunk(int chunkSize, UnpackedMatchPair * matches, int maxPairs); // returns number of bytes processed (0 if we're at end)
+};
+
+struct SALRMJobDesc
+{
+	SuffixArrayMatchFinder * mf;
+	int chunkStart, chunkEnd;
+};
+
+void SuffixArrayMatchFinder::LRMJob(int chunkStart, int chunkEnd)
+{
+	int chunkSize = chunkEnd - chunkStart;
+
+#ifdef OODLE_BUILDING_DATA
+	THREADPROFILESCOPE("SA_LRMJob");
+#endif
+
+	const U8 * ubuf = m_ubuf;
+	int size = m_size;
+
+	lrm_matches.reserve(chunkSize);
+	lrm_matches.clear();
+	for (int i = chunkStart; i < chunkEnd; i++)
+	{
+		UnpackedMatchPair mp;
+		SINTa lrm_offset;
+
+		mp.length = LRMScannerWindowed_FindMatchAndRoll(&scanner, ubuf + i, ubuf + size, &lrm_offset);
+		mp.offset = S32_checkA(lrm_offset);
+		lrm_matches.push_back(mp);
+	}
+}
+
+void OODLE_CALLBACK SuffixArrayMatchFinder::LRMJobShim(void *job_data)
+{
+	SALRMJobDesc *job = static_cast<SALRMJobDesc*>(job_data);
+	job->mf->LRMJob(job->chunkStart, job->chunkEnd);
+}
+
+struct SATreeStackEntry
+{
+	S32 lcp;
+	S32 node;
+	S32 minpos;		// lowest position in the subtree
+	S32 dicpos;		// highest position in the subtree before startRecordingPos, or -1
+};
+
+void SuffixArrayMatchFinder::BuildTree(const S32 * sa, const S32 * lcp, S32 startRecordingPos)
+{
+	THREADPROFILESCOPE("SA_BuildTree");
+
+	S32 size = m_size;
+	SANode * nodes = m_nodes;
+	S32 * leaf_parent = m_leaf_parent;
+
+	vector<SATreeStackEntry> stack;
+	stack.reserve(1024);
+
+	SATreeStackEntry root = { 0, 0, INT_MAX, -1 };
+	stack.push_back(root);
+	S32 nextnode = 1;
+
+	#define SA_ATTACH(e,p) do { \
+		(e).minpos = RR_MIN((e).minpos,(p)); \
+		if ( (p) < startRecordingPos ) (e).dicpos = RR_MAX((e).dicpos,(p)); \
+		} while(0)
+
+	for(S32 r=0;r<size;r++)
+	{
+		S32 s = sa[r];
+		// lcp between r and r+1 ; the end closes everything but the root
+		S32 next_lcp = ( r+1 < size ) ? lcp[r+1] : 0;
+
+		// leaf r goes in the top interval, unless r and r+1 open a deeper one
+		if ( next_lcp <= stack.back().lcp )
+		{
+			leaf_parent[s] = stack.back().node;
+			SA_ATTACH(stack.back(),s);
+		}
+
+		// close intervals that end at r :
+		while( next_lcp < stack.back().lcp )
+		{
+			SATreeStackEntry e = stack.back();
+			stack.pop_back();
+
+			SANode & n = nodes[e.node];
+			n.depth = e.lcp;
+			n.pos = ( e.dicpos >= 0 ) ? e.dicpos : e.minpos;
+
+			if ( next_lcp <= stack.back().lcp )
+			{
+				n.parent = stack.back().node;
+				SATreeStackEntry & p = stack.back();
+				p.minpos = RR_MIN(p.minpos,e.minpos);
+				p.dicpos = RR_MAX(p.dicpos,e.dicpos);
+			}
+			else
+			{
+				// the closed interval is the first child of a new one at next_lcp
+				SATreeStackEntry p = { next_lcp, nextnode++, e.minpos, e.dicpos };
+				n.parent = p.node;
+				stack.push_back(p);
+			}
+		}
+
+		if ( next_lcp > stack.back().lcp )
+		{
+			SATreeStackEntry p = { next_lcp, nextnode++, INT_MAX, -1 };
+			leaf_parent[s] = p.node;
+			SA_ATTACH(p,s);
+			stack.push_back(p);
+		}
+	}
+
+	#undef SA_ATTACH
+
+	RR_ASSERT( stack.size() == 1 );
+	nodes[0].depth = 0;
+	nodes[0].parent = 0;
+	nodes[0].pos = 0;
+
+	m_num_nodes = nextnode;
+	RR_ASSERT( m_num_nodes <= size );
+}
+
+static int sa_num_jobs(SINTa size, OodleLZ_Jobify jobify)
+{
+	int num_jobs = 1;
+	if ( jobify != OodleLZ_Jobify_Disable && Oodle_IsJobSystemSet() )
+		num_jobs = RR_CLAMP(OodlePlugins_GetJobTargetParallelism(),1,SA_MAX_JOBS);
+	num_jobs = (int) RR_MIN( (SINTa)num_jobs, RR_MAX(size / SA_MIN_JOB_SIZE,(SINTa)1) );
+	return num_jobs;
+}
+
+SuffixArrayMatchFinder::SuffixArrayMatchFinder(const U8 * ubuf, S32 size, S32 startRecordingPos, LRMSet * lrms, OodleLZ_Jobify jobify, void * jobify_userPtr)
+{
+	THREADPROFILESCOPE("SA_Create");
+
+	m_ubuf = ubuf;
+	m_size = size;
+	m_pos = startRecordingPos;
+
+	int num_jobs = sa_num_jobs(size,jobify);
+
+	S32 * sa = OODLE_MALLOC_ARRAY(S32,size);
+	S32 * rank = OODLE_MALLOC_ARRAY(S32,size);
+	// the sort and the Phi pass scatter through these :
+	OodleMemoryHint(sa,sizeof(S32)*size,OODLE_MEMORY_HINT_LARGE_RANDOM_ACCESS);
+	OodleMemoryHint(rank,sizeof(S32)*size,OODLE_MEMORY_HINT_LARGE_RANDOM_ACCESS);
+
+	// the SA is unique, so either way gives the same matches
+	if ( num_jobs >= SA_MIN_JOBS_FOR_DOUBLING )
+		sa_suffix_sort(sa,rank,ubuf,size,num_jobs,jobify_userPtr);
+	else
+		sais_sort<U8>(ubuf,sa,size,256);
+
+	// rank is the inverse suffix array now, which we don't need ; reuse it for Phi
+	S32 * lcp = OODLE_MALLOC_ARRAY(S32,size);
+	sa_compute_lcp(lcp,rank,sa,ubuf,size,num_jobs,jobify_userPtr);
+	OODLE_FREE_ARRAY(rank,size);
+
+	m_nodes = OODLE_MALLOC_ARRAY_CACHEALIGNED(SANode,size);
+	m_leaf_parent = OODLE_MALLOC_ARRAY(S32,size);
+	OodleMemoryHint(m_nodes,sizeof(SANode)*size,OODLE_MEMORY_HINT_LARGE_RANDOM_ACCESS);
+	OodleMemoryHint(m_leaf_parent,sizeof(S32)*size,OODLE_MEMORY_HINT_LARGE_RANDOM_ACCESS);
+
+	BuildTree(sa,lcp,startRecordingPos);
+
+	OODLE_FREE_ARRAY(lcp,size);
+	OODLE_FREE_ARRAY(sa,size);
+
+	has_lrm = lrms != NULL;
+	run_lrm_as_job = (jobify != OodleLZ_Jobify_Disable);
+	LRMScannerWindowed_Init(&scanner,lrms,ubuf+startRecordingPos,ubuf+size,RR_S32_MAX);
+	jobifyUserPtr = jobify_userPtr;
+}
+
+SuffixArrayMatchFinder::~SuffixArrayMatchFinder()
+{
+	OODLE_FREE_ARRAY(m_leaf_parent,m_size);
+	OODLE_FREE_ARRAY(m_nodes,m_size);
+}
+
+int SuffixArrayMatchFinder::ProcessChunk(int chunkSize, UnpackedMatchPair * matches, int maxPairs)
+{
+	RR_ASSERT( matches == NULL || maxPairs >= 2 );
+
+	S32 size = m_size;
+	SANode * nodes = m_nodes;
+	const S32 * leaf_parent = m_leaf_parent;
+
+	int chunkStart = m_pos;
+	// same end-of-buffer rule as the trie : no matches in the last 4 bytes
+	int chunkEnd = RR_MIN(chunkStart + chunkSize, size-4); // last position we can find valid-length matches at
+	int realChunkEnd = RR_MIN(chunkStart + chunkSize, size); // last position we're asked to report matches for
+	int chunkPrefetchEnd = chunkEnd - SA_PREFETCH_AHEAD;
+
+	int pos = chunkStart;
+
+	if ( chunkStart < chunkEnd )
+	{
+		// Launch LRM job
+		SALRMJobDesc desc;
+		OODLE_NS_PRE OodleJob lrm_job;
+		bool run_lrm_job = matches && has_lrm;
+
+		if (run_lrm_job)
+		{
+			desc.mf = this;
+			desc.chunkStart = chunkStart;
+			desc.chunkEnd = chunkEnd;
+			lrm_job.run(LRMJobShim, &desc, jobifyUserPtr, run_lrm_as_job);
+		}
+
+		for(pos = chunkStart; pos < chunkEnd; pos++)
+		{
+			if ( pos < chunkPrefetchEnd )
+				RR_PREFETCHRW_32B( &nodes[ leaf_parent[pos + SA_PREFETCH_AHEAD] ] );
+
+			S32 node = leaf_parent[pos];
+
+			// skip intervals that have nothing before pos
+			while( node != 0 && nodes[node].pos >= pos )
+				node = nodes[node].parent;
+
+			int numPairs = 0;
+			int prev_offset = INT_MAX;
+			int parent_steps = 0;
+			UnpackedMatchPair * matchPairs = matches ? matches + (SINTa)(pos - chunkStart)*maxPairs : NULL;
+
+			while( node != 0 )
+			{
+				SANode * n = &nodes[node];
+
+				int length = n->depth;
+				if ( length < SA_MIN_PARENT_LEN && numPairs > 0 )
+				{
+					// still store latest, so a later len 2 longest match gets the lowest offset
+					n->pos = pos;
+					break;
+				}
+
+				int offset = pos - n->pos;
+				RR_ASSERT( offset > 0 );
+
+				// depth can only be < SA_MIN_PARENT_LEN here for the longest match, which the trie reports at len 2 too
+				if ( matchPairs && numPairs < maxPairs && offset < prev_offset && length >= 2 )
+				{
+					matchPairs[numPairs].length = length;
+					matchPairs[numPairs].offset = offset;
+					numPairs++;
+					prev_offset = offset;
+				}
+
+				n->pos = pos;
+
+				if ( ++parent_steps > SA_LIMIT_PARENT_STEPS )
+					break;
+
+				node = n->parent;
+			}
+
+			if ( matchPairs && numPairs < maxPairs )
+				matchPairs[numPairs].length = 0;
+		}
+
+		RR_ASSERT( pos == chunkEnd );
+
+		// Merge LRM results
+		if (run_lrm_job)
+		{
+			lrm_job.wait(jobifyUserPtr);
+
+			const UnpackedMatchPair * lrm_match = &lrm_matches[0];
+			UnpackedMatchPair * out_matches = matches;
+			for (int merge_pos = chunkStart; merge_pos < chunkEnd; merge_pos++, lrm_match++, out_matches += maxPairs)
+			{
+				// same as the trie : only take the LRM match if it's strictly longer
+				if ( lrm_match->length > out_matches[0].length )
+				{
+					memmove(&out_matches[1], &out_matches[0], (maxPairs - 1) * sizeof(UnpackedMatchPair));
+					out_matches[0] = *lrm_match;
+				}
+			}
+		}
+	}
+
+	// generate empty pairs for the ending bit, if any
+	if ( pos < realChunkEnd )
+	{
+		if ( matches )
+		{
+			UnpackedMatchPair * matchPairs = matches + (SINTa)(pos - chunkStart)*maxPairs;
+			for(int i = pos; i<realChunkEnd; i++)
+			{
+				matchPairs[0].length = 0;
+
+				matchPairs += maxPairs;
+			}
+		}
+
+		pos = realChunkEnd;
+	}
+
+	m_pos = pos;
+
+	return realChunkEnd - chunkStart;
+}
+
+//===========================================================
+
+IncrementalMatchFinder * SuffixArray_CreateMatchFinder(const U8 * ubuf,SINTa sizeA,
+		SINTa startRecordingPosA,
+		LRMSet * lrms,
+		OodleLZ_Jobify jobify,
+		void * jobifyUserPtr)
+{
+	RR_ASSERT_ALWAYS( sizeA > 0 && sizeA < RR_S32_MAX );
+
+	// prefix doubling forms s + h in S32, which can reach 2*size ; the trie has no such step
+	if ( sizeA > SuffixArray_MaxSize )
+		return SuffixTrie_CreateMatchFinder(ubuf,sizeA,startRecordingPosA,lrms,jobify,jobifyUserPtr);
+
+	S32 size = S32_checkA(sizeA);
+	S32 startRecordingPos = S32_checkA(startRecordingPosA);
+	RR_ASSERT( startRecordingPos >= 0 && startRecordingPos < size );
+
+	return OodleNewT(SuffixArrayMatchFinder)(ubuf,size,startRecordingPos,lrms,jobify,jobifyUserPtr);
+}
+
+bool SuffixArray_CreateRunsJobs(SINTa size,OodleLZ_Jobify jobify)
+{
+	// the trie fallback doesn't run jobs
+	if ( size > SuffixArray_MaxSize )
+		return false;
+	
+	return sa_num_jobs(size,jobify) > 1;
+}
+
+//===========================================================
+
+OODLE_NS_END
+#endif // OODLE_PLATFORM_HAS_ADVANCED_MATCHERS